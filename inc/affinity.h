@@ -0,0 +1,65 @@
+/**
+ * @file affinity.h
+ * @author Emirhan Altunel
+ * @brief Header file for the affinity module. Contains CPU pinning and placement of the processes.
+ * @date 2026-10-19
+ */
+#ifndef INC_AFFINITY
+#define INC_AFFINITY
+
+#define MAX_PLACEMENT_CPUS 64 /** Maximum number of CPUs in a placement list */
+
+/**
+ * @brief Parses a CPU list.
+ * 
+ * @param str List of CPUs such as "0,2,4-6".
+ * @param cpus Array that receives the CPUs in the given order.
+ * @param max Capacity of the array.
+ * 
+ * @return Number of CPUs in the list, -1 if the list is invalid or too long.
+ */
+int parse_cpu_list(const char* str, int* cpus, int max);
+
+/**
+ * @brief Builds a placement list where neighbours share a cache.
+ * 
+ * @param cpus Array that receives the CPUs.
+ * @param max Capacity of the array.
+ * 
+ * The list starts with the first CPU the process may run on, followed by the CPUs that share its
+ * last level cache and then by the remaining allowed CPUs. Roles that communicate the most get
+ * neighbouring entries, so they land on cores that share a cache. If the cache topology can not be
+ * read, the fallback to the plain CPU order is reported on the standard error.
+ * 
+ * @return Number of CPUs in the list, -1 on error.
+ */
+int auto_cpu_list(int* cpus, int max);
+
+#define PLACEMENT_FAILED -2 /** place_self() result when pinning failed */
+
+/**
+ * @brief Pins the calling process or thread to a CPU and sets the local allocation policy.
+ * 
+ * @param cpus Placement list.
+ * @param count Number of CPUs in the list, 0 to leave the placement alone.
+ * @param role Index of the caller. The caller is pinned to cpus[role % count].
+ * @param name Name of the caller, used to report a failure.
+ * 
+ * Memory is allocated on first touch, so only the pages the caller touches first after this call
+ * come from the NUMA node of the CPU. Buffers another process or thread filled before, such as the
+ * random numbers the parent generates for its children or workers, stay on the node they were
+ * touched on. A failure is reported with the reason on the standard error. A failure to set the
+ * allocation policy is only reported, the caller stays pinned.
+ * 
+ * @return The CPU the caller is pinned to, -1 if count is 0, PLACEMENT_FAILED on error.
+ */
+int place_self(const int* cpus, int count, int role, const char* name);
+
+/**
+ * @brief Counts the CPUs the calling process or thread may run on.
+ * 
+ * @return Number of CPUs in the affinity mask of the caller, 1 if it can not be read.
+ */
+int allowed_cpu_count();
+
+#endif /* INC_AFFINITY */
@@ -0,0 +1,91 @@
+/**
+ * @file arena.h
+ * @author Emirhan Altunel
+ * @brief Header file for the arena module. Contains a region allocator for per-job buffers.
+ * @date 2026-10-19
+ */
+#ifndef INC_ARENA
+#define INC_ARENA
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (1 << 20)     /** Default size of an arena block */
+#define ARENA_HUGE_PAGE_SIZE (1 << 21) /** Size of a huge page */
+
+/**
+ * @brief Block of memory mapped for an arena. The header is stored at the start of the block.
+ */
+typedef struct arena_block_s {
+  struct arena_block_s* next; /** Next block of the arena */
+  size_t                size; /** Size of the block including the header */
+  size_t                used; /** Number of bytes used including the header */
+} arena_block_t;
+
+/**
+ * @brief Region allocator. Memory is taken from mapped blocks and released all at once.
+ */
+typedef struct arena_s {
+  arena_block_t* blocks;     /** List of the mapped blocks */
+  arena_block_t* current;    /** Block the next allocation is tried from */
+  int            huge_pages; /** 1 to back large blocks with huge pages */
+} arena_t;
+
+/**
+ * @brief Initializes an arena.
+ * 
+ * @param arena Arena to initialize.
+ * @param huge_pages 1 to back blocks of at least ARENA_HUGE_PAGE_SIZE bytes with huge pages.
+ * 
+ * No memory is mapped until the first allocation. A zero initialized arena_t is also a valid empty arena.
+ * 
+ * @return void
+ */
+void arena_init(arena_t* arena, int huge_pages);
+
+/**
+ * @brief Allocates memory from the arena.
+ * 
+ * @param arena Arena to allocate from.
+ * @param size Number of bytes to allocate.
+ * 
+ * The memory is aligned for any type. It is not zeroed when it is reused after arena_reset().
+ * Blocks of the arena are reused before a new block is mapped.
+ * 
+ * @return Pointer to the memory. NULL on error.
+ */
+void* arena_alloc(arena_t* arena, size_t size);
+
+/**
+ * @brief Duplicates a string into the arena.
+ * 
+ * @param arena Arena to allocate from.
+ * @param s String to duplicate.
+ * 
+ * @return The duplicated string. NULL on error.
+ */
+char* arena_strdup(arena_t* arena, const char* s);
+
+/**
+ * @brief Releases every allocation of the arena at once.
+ * 
+ * @param arena Arena to reset.
+ * 
+ * The blocks stay mapped and are reused by the next job.
+ * 
+ * @return void
+ */
+void arena_reset(arena_t* arena);
+
+/**
+ * @brief Unmaps every block of the arena.
+ * 
+ * @param arena Arena to destroy.
+ * 
+ * It only uses munmap(), so it can be called from a signal handler.
+ * The arena is empty afterwards and can be used again.
+ * 
+ * @return void
+ */
+void arena_destroy(arena_t* arena);
+
+#endif /* INC_ARENA */
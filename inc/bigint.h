@@ -0,0 +1,89 @@
+/**
+ * @file bigint.h
+ * @author Emirhan Altunel
+ * @brief Header file for the bigint module. Contains an arbitrary-precision unsigned integer used for exact products.
+ * @date 2026-10-19
+ */
+#ifndef INC_BIGINT
+#define INC_BIGINT
+
+#include <stdint.h>
+
+#define KARATSUBA_THRESHOLD 32 /** Number of limbs from which Karatsuba multiplication is used */
+
+/**
+ * @brief Arbitrary-precision unsigned integer with little-endian 32-bit limbs.
+ */
+typedef struct bigint_s {
+  uint32_t* limbs; /** Limbs of the integer, least significant first */
+  int       size;  /** Number of used limbs, 0 for zero */
+} bigint_t;
+
+/**
+ * @brief Initializes a big integer from an unsigned integer.
+ * 
+ * @param n Big integer to initialize.
+ * @param value Value of the integer.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int bigint_init(bigint_t* n, uint32_t value);
+
+/**
+ * @brief Frees the memory of a big integer.
+ * 
+ * @param n Big integer to free.
+ * 
+ * @return void
+ */
+void bigint_free(bigint_t* n);
+
+/**
+ * @brief Multiplies two big integers.
+ * 
+ * @param result Big integer that receives the product. It must not be initialized.
+ * @param a First factor.
+ * @param b Second factor.
+ * 
+ * Schoolbook multiplication is used for small factors, Karatsuba multiplication for large ones.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int bigint_mul(bigint_t* result, const bigint_t* a, const bigint_t* b);
+
+/**
+ * @brief Calculates the exact product of the numbers.
+ * 
+ * @param result Big integer that receives the product. It must not be initialized.
+ * @param numbers Array of non-negative integers.
+ * @param n Number of integers in the array.
+ * @param threads Number of threads that may work on the product, 1 to stay in the calling thread.
+ * 
+ * The numbers are multiplied as a balanced product tree, so the factors of every multiplication
+ * have about the same size and the large multiplications benefit from Karatsuba.
+ * The branches of the tree are independent and are split over the given number of threads.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int bigint_product(bigint_t* result, const int* numbers, int n, int threads);
+
+/**
+ * @brief Adds an unsigned integer to a big integer.
+ * 
+ * @param n Big integer to add to.
+ * @param value Value to add.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int bigint_add_uint(bigint_t* n, uint32_t value);
+
+/**
+ * @brief Converts a big integer to a decimal string.
+ * 
+ * @param n Big integer to convert.
+ * 
+ * @return The decimal string. Use free() to free the memory. NULL on error.
+ */
+char* bigint_to_string(const bigint_t* n);
+
+#endif /* INC_BIGINT */
@@ -0,0 +1,52 @@
+/**
+ * @file deadline.h
+ * @author Emirhan Altunel
+ * @brief Header file for the deadline module. Contains job deadlines based on timerfd and the typed job result.
+ * @date 2026-10-19
+ */
+#ifndef INC_DEADLINE
+#define INC_DEADLINE
+
+#define TIMEOUT_EXIT 124 /** Exit status of a job that exceeded its deadline */
+
+/**
+ * @brief Result of a job.
+ */
+typedef enum job_result_e {
+  JOB_OK,      /** The job finished in time */
+  JOB_TIMEOUT, /** The job exceeded its deadline and was cancelled, its late results were discarded */
+  JOB_FAILED,  /** The job failed */
+} job_result_t;
+
+/**
+ * @brief Starts a one-shot deadline timer.
+ * 
+ * @param milliseconds Time until the deadline expires.
+ * 
+ * @return File descriptor of the timer, readable once the deadline expired, -1 on error.
+ */
+int deadline_start(int milliseconds);
+
+/**
+ * @brief Waits until the deadline expires, another file descriptor is readable or the timeout elapses.
+ * 
+ * @param timer File descriptor of the timer, -1 for no deadline.
+ * @param fd Other file descriptor to wait for, -1 for none.
+ * @param timeout Timeout in milliseconds, -1 to wait without a timeout.
+ * 
+ * A signal interrupts the wait like a readable file descriptor does.
+ * 
+ * @return 1 if the deadline expired, 0 otherwise, -1 on error.
+ */
+int deadline_wait(int timer, int fd, int timeout);
+
+/**
+ * @brief Converts a job result to the exit status of the program.
+ * 
+ * @param result Result of the job.
+ * 
+ * @return 0 for JOB_OK, TIMEOUT_EXIT for JOB_TIMEOUT and 1 for JOB_FAILED.
+ */
+int job_exit_status(job_result_t result);
+
+#endif /* INC_DEADLINE */
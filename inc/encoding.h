@@ -0,0 +1,148 @@
+/**
+ * @file encoding.h
+ * @author Emirhan Altunel
+ * @brief Header file for the encoding module. Contains compact payload encodings for arrays of integers.
+ * @date 2026-10-19
+ */
+#ifndef INC_ENCODING
+#define INC_ENCODING
+
+#include <stats.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define DECODER_BUFFER_SIZE (1 << 14) /** Number of payload bytes a decoder reads at once */
+#define DECODE_CHUNK_SIZE 1024        /** Number of integers decoded per chunk by the reduction kernels */
+
+/**
+ * @brief Enumeration for the payload encodings.
+ */
+typedef enum encoding_e {
+  ENCODING_RAW,     /** Native 4-byte integers */
+  ENCODING_BITPACK, /** Offsets from the minimum packed with the width of the range */
+  ENCODING_VARINT,  /** Zigzag varints, for integers of any range */
+  ENCODING_AUTO,    /** Smallest of the encodings above, only a request */
+} encoding_t;
+
+/**
+ * @brief Header sent before every payload. It tells the receiver how to decode the payload.
+ */
+typedef struct payload_header_s {
+  int encoding; /** Encoding of the payload */
+  int count;    /** Number of integers */
+  int base;     /** Minimum of the integers, used by ENCODING_BITPACK */
+  int bits;     /** Number of bits per integer, used by ENCODING_BITPACK */
+  int size;     /** Number of bytes of the payload */
+} payload_header_t;
+
+/**
+ * @brief Function that reads exactly count bytes of the payload, less only at end of file.
+ */
+typedef ssize_t (*payload_reader_t)(int fd, void* buf, size_t count);
+
+/**
+ * @brief Streaming decoder. It reads the payload in DECODER_BUFFER_SIZE pieces, so memory use is constant.
+ */
+typedef struct decoder_s {
+  payload_header_t header;   /** Header of the payload */
+  payload_reader_t reader;   /** Function that reads the payload */
+  int              fd;       /** File descriptor the payload is read from */
+  int              decoded;  /** Number of integers decoded so far */
+  int              remaining; /** Number of payload bytes not read yet */
+  unsigned char    input[DECODER_BUFFER_SIZE]; /** Payload bytes read but not decoded */
+  size_t           input_size; /** Number of valid bytes in input */
+  size_t           position;   /** Index of the next byte of input to decode */
+  uint64_t         bit_buffer; /** Bits read but not decoded, used by ENCODING_BITPACK */
+  int              bit_count;  /** Number of valid bits in bit_buffer */
+} decoder_t;
+
+/**
+ * @brief Returns the name of an encoding.
+ * 
+ * @param encoding Encoding to name.
+ * 
+ * @return The name of the encoding.
+ */
+const char* encoding_name(int encoding);
+
+/**
+ * @brief Parses the name of an encoding.
+ * 
+ * @param name Name to parse: raw, bitpack, varint or auto.
+ * 
+ * @return The encoding, -1 if the name is unknown.
+ */
+int parse_encoding(const char* name);
+
+/**
+ * @brief Returns the maximum number of bytes an encoding needs for an array.
+ * 
+ * @param n Number of integers in the array.
+ * 
+ * @return The number of bytes enough for every encoding.
+ */
+size_t encoded_size_bound(int n);
+
+/**
+ * @brief Encodes an array of integers.
+ * 
+ * @param numbers Array of integers.
+ * @param n Number of integers in the array.
+ * @param encoding Requested encoding. ENCODING_AUTO picks the smallest one.
+ * @param header Header that receives the encoding, the count and the size of the payload.
+ * @param out Buffer of at least encoded_size_bound(n) bytes that receives the payload.
+ * 
+ * @return 0 on success, -1 if the encoding is unknown.
+ */
+int encode_numbers(const int* numbers, int n, int encoding,
+                   payload_header_t* header, unsigned char* out);
+
+/**
+ * @brief Initializes a streaming decoder.
+ * 
+ * @param decoder Decoder to initialize.
+ * @param header Header of the payload, already read by the caller.
+ * @param reader Function that reads the payload.
+ * @param fd File descriptor the payload is read from.
+ * 
+ * @return 0 on success, -1 if the header is invalid.
+ */
+int decoder_init(decoder_t* decoder, const payload_header_t* header,
+                 payload_reader_t reader, int fd);
+
+/**
+ * @brief Decodes the next integers of the payload.
+ * 
+ * @param decoder Decoder to use.
+ * @param out Array that receives the integers.
+ * @param max Capacity of the array.
+ * 
+ * Only the bytes of the payload are read, data after the payload stays in the file descriptor.
+ * 
+ * @return Number of integers decoded, 0 once the payload is complete, -1 on error.
+ */
+int decoder_next(decoder_t* decoder, int* out, int max);
+
+/**
+ * @brief Decodes the payload and calculates the sum of the integers in a single pass.
+ * 
+ * @param decoder Decoder to use.
+ * @param sum Pointer that receives the sum.
+ * @param stats Statistics updated with every decoded chunk, NULL to skip them.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int decode_sum(decoder_t* decoder, int* sum, stream_stats_t* stats);
+
+/**
+ * @brief Decodes the payload and calculates the product of the integers in a single pass.
+ * 
+ * @param decoder Decoder to use.
+ * @param product Pointer that receives the product, wrapped modulo 2^32.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int decode_product(decoder_t* decoder, int* product);
+
+#endif /* INC_ENCODING */
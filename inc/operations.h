@@ -0,0 +1,77 @@
+/**
+ * @file operations.h
+ * @author Emirhan Altunel
+ * @brief Header file for the operations module. Contains the computations shared by every execution engine.
+ * @date 2026-10-19
+ */
+#ifndef INC_OPERATIONS
+#define INC_OPERATIONS
+
+/**
+ * @brief Fills the array with random numbers between 1 and 10.
+ * 
+ * @param numbers Array to fill.
+ * @param n Number of integers in the array.
+ * 
+ * The random number generator is seeded with the current time.
+ * 
+ * @return void
+ */
+void generate_random_numbers(int* numbers, int n);
+
+/**
+ * @brief Calculates the sum of the numbers.
+ * 
+ * @param numbers Array of integers.
+ * @param n Number of integers in the array.
+ * 
+ * @return The sum of the numbers.
+ */
+int sum_numbers(const int* numbers, int n);
+
+/**
+ * @brief Calculates the product of the numbers.
+ * 
+ * @param numbers Array of integers.
+ * @param n Number of integers in the array.
+ * 
+ * The product wraps around modulo 2^32 instead of overflowing.
+ * 
+ * @return The product of the numbers.
+ */
+int multiply_numbers(const int* numbers, int n);
+
+/**
+ * @brief Calculates the exact product of the numbers and the exact sum of the two results.
+ * 
+ * @param numbers Array of integers between 1 and 10.
+ * @param n Number of integers in the array.
+ * @param sum Sum of the numbers.
+ * @param threads Number of threads that may work on the product.
+ * @param product Receives the exact product in decimal.
+ * @param total Receives the exact product plus the sum in decimal.
+ * 
+ * Use free() to free both strings.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int exact_result(const int* numbers, int n, int sum, int threads,
+                 char** product, char** total);
+
+/**
+ * @brief Calculates and prints the exact product of the numbers and the exact sum of the two results.
+ * 
+ * @param sender Name of the process or thread that prints the result.
+ * @param numbers Array of integers between 1 and 10.
+ * @param n Number of integers in the array.
+ * @param sum Sum of the numbers.
+ * @param threads Number of threads that may work on the product.
+ * 
+ * The product is calculated with bigint_product() and printed in decimal.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int print_exact_result(const char* sender, const int* numbers, int n, int sum,
+                       int threads);
+
+#endif /* INC_OPERATIONS */
@@ -0,0 +1,63 @@
+/**
+ * @file options.h
+ * @author Emirhan Altunel
+ * @brief Header file for the options module. Contains the command line parser.
+ * @date 2026-10-19
+ */
+#ifndef INC_OPTIONS
+#define INC_OPTIONS
+
+#include <affinity.h>
+#include <encoding.h>
+#include <trace.h>
+
+#define DEFAULT_RANDOM_NUMBERS 5 /** Default number of random numbers */
+
+/**
+ * @brief Options given on the command line.
+ */
+typedef struct options_s {
+  int numberOfRandomNumbers; /** Number of random numbers to generate */
+  int threads;               /** 1 to run the jobs as threads instead of child processes */
+  int workers;               /** Number of work-stealing workers, 0 to run the two children */
+  int chunk_size;            /** Number of integers in a chunk task of the work-stealing workers */
+  int exact;                 /** 1 to also print the exact product as a big integer */
+  int huge_pages;            /** 1 to back large job buffers with huge pages */
+  int cpus[MAX_PLACEMENT_CPUS]; /** CPU of every role, the parent is role 0 */
+  int cpu_count;                /** Number of CPUs in the placement list, 0 to float freely */
+  int io_uring;                 /** 1 to move the fifo traffic and the log to io_uring */
+  int encoding;                 /** Payload encoding requested for the fifo traffic */
+  int stats;                    /** 1 to print streaming statistics of the numbers */
+  int retries;                  /** Number of worker respawns the supervisor may spend */
+  int deadline;                 /** Deadline of the job in milliseconds, 0 for none */
+  const char* trace;            /** File that records the fifo traffic, NULL for none */
+  const char* replay;           /** Trace whose parent messages replace the generated job, NULL for none */
+  int replay_speed;             /** Speed of the replay */
+  const char* pipeline;         /** Description of a stage graph to run, NULL for none */
+  const char* pipeline_file;    /** File with the description of a stage graph, NULL for none */
+  int fake_error;               /** 1 to make the parent fail after forking the children */
+} options_t;
+
+/**
+ * @brief Parses the command line.
+ * 
+ * @param argc Number of arguments.
+ * @param argv Array of arguments.
+ * @param options Options to fill.
+ * 
+ * Options that are not given keep their default values.
+ * 
+ * @return 0 on success, -1 if the command line is invalid.
+ */
+int parse_options(int argc, char* argv[], options_t* options);
+
+/**
+ * @brief Prints the usage message to the standard error.
+ * 
+ * @param name Name of the program.
+ * 
+ * @return void
+ */
+void print_usage(const char* name);
+
+#endif /* INC_OPTIONS */
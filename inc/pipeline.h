@@ -0,0 +1,108 @@
+/**
+ * @file pipeline.h
+ * @brief Header file for the pipeline module.
+ *
+ * This file contains the declarations for the pipeline engine, which runs a job described by a
+ * declarative stage graph instead of the fixed parent, first child and second child topology.
+ * A description such as "gen:1000 -> map:square x2 -> filter:even -> reduce:sum x2" lists the
+ * stages in data flow order. Every stage has an operator and a parallelism, and every instance
+ * of a stage is a process. Each instance reads chunk messages from its own pipe, applies its
+ * operator and spreads the resulting chunks over the pipes of the next stage round robin. The
+ * instances of the reduce stage send their partial results to the parent, which merges them.
+ */
+#ifndef INC_PIPELINE
+#define INC_PIPELINE
+
+#include <deadline.h>
+#include <limits.h>
+#include <options.h>
+
+#define STAGE_NAME "\033[1;36m[Stage]\033[0m" /** Name of the stage processes */
+
+#define MAX_STAGES 16                 /** Maximum number of stages in a pipeline */
+#define MAX_PIPELINE_INSTANCES 64     /** Maximum number of stage processes in a pipeline */
+#define MAX_PIPELINE_FILE 4096        /** Maximum size of a pipeline description file */
+#define STAGE_TEXT_SIZE 32            /** Size of the text of a stage, such as "map:square" */
+#define PIPELINE_CHUNK_SIZE (PIPE_BUF / (int)sizeof(int) - 1) /** Integers in a chunk message, so a message is written atomically */
+
+/**
+ * @brief Enumeration for the kinds of stages.
+ */
+typedef enum stage_kind_e {
+  STAGE_GEN,    /** Generates random numbers, first stage only */
+  STAGE_MAP,    /** Replaces every number */
+  STAGE_FILTER, /** Keeps the numbers that match a predicate */
+  STAGE_REDUCE, /** Reduces the numbers to one value, last stage only */
+} stage_kind_t;
+
+/**
+ * @brief Enumeration for the operators of the stages.
+ */
+typedef enum stage_operator_e {
+  OPERATOR_GEN,
+  OPERATOR_SQUARE,
+  OPERATOR_DOUBLE,
+  OPERATOR_NEGATE,
+  OPERATOR_INCREMENT,
+  OPERATOR_EVEN,
+  OPERATOR_ODD,
+  OPERATOR_POSITIVE,
+  OPERATOR_SUM,
+  OPERATOR_PRODUCT,
+  OPERATOR_MIN,
+  OPERATOR_MAX,
+  OPERATOR_COUNT,
+} stage_operator_t;
+
+/**
+ * @brief A stage of a pipeline.
+ */
+typedef struct stage_s {
+  stage_kind_t     kind;                  /** Kind of the stage */
+  stage_operator_t op;                    /** Operator of the stage */
+  int              count;                 /** Number of random numbers of a gen stage */
+  int              parallelism;           /** Number of instances of the stage */
+  char             text[STAGE_TEXT_SIZE]; /** Operator as written in the description */
+} stage_t;
+
+/**
+ * @brief A linear chain of stages.
+ */
+typedef struct pipeline_s {
+  stage_t stages[MAX_STAGES]; /** Stages in data flow order */
+  int     count;              /** Number of stages */
+} pipeline_t;
+
+/**
+ * @brief Partial result of a reduce instance.
+ */
+typedef struct reduce_result_s {
+  int value; /** Reduced value */
+  int count; /** Number of numbers that were reduced */
+} reduce_result_t;
+
+/**
+ * @brief Parses a pipeline description.
+ * 
+ * @param description Stages separated by "->". A stage is an operator followed by an optional "xN" parallelism.
+ * @param pipeline Pipeline to fill.
+ * 
+ * The operators are gen:N, map:square, map:double, map:negate, map:increment, filter:even,
+ * filter:odd, filter:positive, reduce:sum, reduce:product, reduce:min, reduce:max and reduce:count.
+ * The first stage must be gen and the last stage must be a reduce. Whitespace, including newlines,
+ * separates the words of a stage.
+ * 
+ * @return 0 on success, -1 if the description is invalid.
+ */
+int pipeline_parse(const char* description, pipeline_t* pipeline);
+
+/**
+ * @brief The pipeline engine.
+ * 
+ * @param options The options of the job, with the description in pipeline or pipeline_file.
+ * 
+ * @return JOB_OK on success, JOB_FAILED on error.
+ */
+job_result_t pipeline_engine(const options_t* options);
+
+#endif /* INC_PIPELINE */
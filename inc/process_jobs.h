@@ -8,6 +8,10 @@
 #ifndef INC_PROCESS_JOBS
 #define INC_PROCESS_JOBS
 
+#include <deadline.h>
+#include <options.h>
+#include <signal.h>
+
 #define fifo1 "fifo1" /** Name of the first FIFO */
 #define fifo2 "fifo2" /** Name of the second FIFO */
 
@@ -20,11 +24,28 @@
 
 #define SELF_EXIT 200 /** Exit status for self exit */
 
+#define MAX_RANDOM_NUMBERS \
+  (1 << 24) /** Maximum number of random numbers in a job */
+
+/**
+ * @brief Results the second child reports to the parent.
+ *
+ * The exact product and the exact sum follow the report as decimal strings
+ * without terminators.
+ */
+typedef struct job_report_s {
+  int product;       /** Result of the multiplication */
+  int total;         /** Sum of the two children's results */
+  int exact_product; /** Length of the exact product, 0 without --exact */
+  int exact_total;   /** Length of the exact sum, 0 without --exact */
+} job_report_t;
+
 extern int child_count; /** Number of child processes */
+extern volatile sig_atomic_t job_cancelled; /** 1 once the parent cancelled the job */
 
-int first_child();
-int second_child();
-int parent(int numberOfRandomNumbers);
+int first_child(const options_t* options);
+int second_child(const options_t* options);
+job_result_t parent(const options_t* options);
 int open_fifos();
 int clear_all();
 int unlink_fifos();
@@ -0,0 +1,105 @@
+/**
+ * @file safe_io.h
+ * @author Emirhan Altunel
+ * @brief Header file for the safe I/O module. Contains full-transfer read and write helpers.
+ * @date 2026-10-19
+ */
+#ifndef INC_SAFE_IO
+#define INC_SAFE_IO
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Reads exactly count bytes from the file descriptor.
+ * 
+ * @param fd File descriptor to read from.
+ * @param buf Buffer to read into.
+ * @param count Number of bytes to read.
+ * 
+ * The function keeps calling read() until count bytes are transferred.
+ * Calls interrupted by a signal are retried.
+ * If the file descriptor is in nonblocking mode, it waits with poll() until data is available.
+ * 
+ * @return Number of bytes read. It is less than count only if end of file is reached. -1 on error.
+ */
+ssize_t read_all(int fd, void* buf, size_t count);
+
+/**
+ * @brief Writes exactly count bytes to the file descriptor.
+ * 
+ * @param fd File descriptor to write to.
+ * @param buf Buffer to write from.
+ * @param count Number of bytes to write.
+ * 
+ * The function keeps calling write() until count bytes are transferred.
+ * Calls interrupted by a signal are retried.
+ * If the file descriptor is in nonblocking mode, it waits with poll() until space is available.
+ * 
+ * @return count on success, -1 on error.
+ */
+ssize_t write_all(int fd, const void* buf, size_t count);
+
+/**
+ * @brief Reads exactly the total length of the iovec array from the file descriptor.
+ * 
+ * @param fd File descriptor to read from.
+ * @param iov Array of buffers to read into.
+ * @param iovcnt Number of buffers in the array.
+ * 
+ * Same as read_all() but scatters the data with readv().
+ * The iovec array is modified while the transfer progresses.
+ * 
+ * @return Number of bytes read. It is less than the total length only if end of file is reached. -1 on error.
+ */
+ssize_t readv_all(int fd, struct iovec* iov, int iovcnt);
+
+/**
+ * @brief Writes exactly the total length of the iovec array to the file descriptor.
+ * 
+ * @param fd File descriptor to write to.
+ * @param iov Array of buffers to write from.
+ * @param iovcnt Number of buffers in the array.
+ * 
+ * Same as write_all() but gathers the data with writev(), so a message header and its payload
+ * leave with a single system call whenever the channel has enough room.
+ * The iovec array is modified while the transfer progresses.
+ * 
+ * @return Total length on success, -1 on error.
+ */
+ssize_t writev_all(int fd, struct iovec* iov, int iovcnt);
+
+/**
+ * @brief Function that waits until a nonblocking file descriptor is ready.
+ * 
+ * It returns 0 to retry the transfer and -1 to give up.
+ */
+typedef int (*io_wait_t)(int fd, short events);
+
+/**
+ * @brief Writes exactly the total length of the iovec array to a nonblocking file descriptor.
+ * 
+ * @param fd File descriptor to write to.
+ * @param iov Array of buffers to write from.
+ * @param iovcnt Number of buffers in the array.
+ * @param wait Function that waits while the file descriptor is full.
+ * 
+ * Same as writev_all() but the caller decides how to wait, so the wait can also watch a
+ * deadline or other events and give up the transfer.
+ * 
+ * @return Total length on success, -1 on error or if the wait gave up.
+ */
+ssize_t writev_wait(int fd, struct iovec* iov, int iovcnt, io_wait_t wait);
+
+/**
+ * @brief Enables or disables nonblocking mode on the file descriptor.
+ * 
+ * @param fd File descriptor to change.
+ * @param enable 1 to enable nonblocking mode, 0 to disable it.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int set_nonblocking(int fd, int enable);
+
+#endif /* INC_SAFE_IO */
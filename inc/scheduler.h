@@ -0,0 +1,79 @@
+/**
+ * @file scheduler.h
+ * @brief Header file for the work-stealing scheduler module.
+ *
+ * This file contains the declarations for the scheduler engine. A job is split into chunk tasks that are
+ * spread over per-worker deques living in shared memory. Every worker process pops tasks from the bottom
+ * of its own deque and, once it runs dry, steals from the top of the other deques. Each chunk is reduced
+ * with the first and second child operations and the partial results are merged in chunk order.
+ *
+ * With a retry budget the parent supervises the workers. The state of every chunk is tracked in shared
+ * memory, so when a worker dies only the chunks it had claimed but not acknowledged are requeued, and
+ * the worker is respawned after an exponential backoff. Acknowledged partial results are kept.
+ *
+ * A job with a deadline is cancelled when its timer expires. The workers stop at their next chunk
+ * boundary and the partial results are discarded.
+ */
+#ifndef INC_SCHEDULER
+#define INC_SCHEDULER
+
+#include <deadline.h>
+#include <options.h>
+#include <pthread.h>
+#include <stats.h>
+#include <stddef.h>
+
+#define WORKER_NAME "\033[1;35m[Worker]\033[0m" /** Name of the worker processes */
+
+#define MAX_WORKERS 64                /** Maximum number of worker processes */
+#define DEFAULT_CHUNK_SIZE (1 << 14)  /** Default number of integers in a chunk task */
+#define RETRY_BACKOFF_MS 1            /** Delay before the first respawn of a failed worker */
+#define MAX_BACKOFF_MS 1000           /** Upper bound of the respawn delay */
+#define CANCEL_GRACE_MS 1000          /** Time a cancelled worker has to finish its chunk before it is killed */
+
+#define CHUNK_PENDING -1                     /** State of a chunk task waiting in a deque */
+#define CHUNK_DONE(worker) (MAX_WORKERS + (worker)) /** State of a chunk task acknowledged by a worker */
+
+/**
+ * @brief Deque of chunk task indices owned by one worker.
+ * 
+ * Tasks live in the ring between top and bottom. The owner pops from the bottom and thieves steal from the top.
+ */
+typedef struct worker_deque_s {
+  pthread_mutex_t lock;     /** Process-shared lock guarding the deque */
+  int*            tasks;    /** Ring of chunk task indices */
+  int             top;      /** Index of the oldest task */
+  int             bottom;   /** Index after the newest task */
+  int             executed; /** Number of tasks executed by the owner */
+  int             stolen;   /** Number of tasks the owner stole from other workers */
+} worker_deque_t;
+
+/**
+ * @brief Partial result of a chunk task.
+ */
+typedef struct chunk_result_s {
+  int sum;     /** Sum of the chunk */
+  int product; /** Product of the chunk */
+} chunk_result_t;
+
+/**
+ * @brief State of the scheduler. Every pointer refers to the shared memory region.
+ */
+typedef struct scheduler_s {
+  int*            numbers;      /** Array of numbers of the job */
+  int             count;        /** Number of integers in the job */
+  int             chunk_size;   /** Number of integers in a chunk task */
+  int             chunk_count;  /** Number of chunk tasks */
+  int             worker_count; /** Number of worker processes */
+  worker_deque_t* deques;       /** One deque per worker */
+  chunk_result_t* results;      /** One partial result per chunk task */
+  stream_stats_t* stats;        /** One partial statistics state per worker, NULL without --stats */
+  int*            chunk_states; /** CHUNK_PENDING, the claiming worker or CHUNK_DONE of every chunk task */
+  int*            cancelled;    /** Set to 1 by the parent to cancel the job, checked by the workers between chunks */
+  void*           region;       /** Shared memory region */
+  size_t          region_size;  /** Size of the shared memory region */
+} scheduler_t;
+
+job_result_t scheduler_engine(const options_t* options);
+
+#endif /* INC_SCHEDULER */
@@ -0,0 +1,91 @@
+/**
+ * @file spsc_queue.h
+ * @author Emirhan Altunel
+ * @brief Header file for the single-producer single-consumer queue module.
+ * @date 2026-10-19
+ */
+#ifndef INC_SPSC_QUEUE
+#define INC_SPSC_QUEUE
+
+#define SPSC_QUEUE_CAPACITY 16 /** Number of slots in a queue, must be a power of two */
+
+/**
+ * @brief Message passed between the threads of the thread engine.
+ */
+typedef struct thread_message_s {
+  const char* command; /** Command to be executed, NULL if there is none */
+  const int*  numbers; /** Array of numbers shared with the producer */
+  int         count;   /** Number of integers in the array */
+  int         value;   /** Scalar result carried by the message */
+} thread_message_t;
+
+/**
+ * @brief Lock-free ring buffer with one producer and one consumer.
+ * 
+ * The producer only writes tail and the consumer only writes head, so the two sides
+ * synchronize with acquire and release loads and stores without any lock.
+ */
+typedef struct spsc_queue_s {
+  thread_message_t slots[SPSC_QUEUE_CAPACITY];
+  unsigned int     head; /** Index of the next slot to pop */
+  unsigned int     tail; /** Index of the next slot to push */
+} spsc_queue_t;
+
+/**
+ * @brief Initializes the queue.
+ * 
+ * @param queue Queue to initialize.
+ * 
+ * @return void
+ */
+void spsc_queue_init(spsc_queue_t* queue);
+
+/**
+ * @brief Pushes a message to the queue.
+ * 
+ * @param queue Queue to push to.
+ * @param message Message to push.
+ * 
+ * Must only be called by the producer thread.
+ * 
+ * @return 0 on success, -1 if the queue is full.
+ */
+int spsc_queue_push(spsc_queue_t* queue, const thread_message_t* message);
+
+/**
+ * @brief Pushes a message to the queue, waiting until there is room.
+ * 
+ * @param queue Queue to push to.
+ * @param message Message to push.
+ * 
+ * The calling thread yields the processor while the queue is full.
+ * 
+ * @return void
+ */
+void spsc_queue_push_wait(spsc_queue_t* queue, const thread_message_t* message);
+
+/**
+ * @brief Pops a message from the queue.
+ * 
+ * @param queue Queue to pop from.
+ * @param message Message to pop into.
+ * 
+ * Must only be called by the consumer thread.
+ * 
+ * @return 0 on success, -1 if the queue is empty.
+ */
+int spsc_queue_pop(spsc_queue_t* queue, thread_message_t* message);
+
+/**
+ * @brief Pops a message from the queue, waiting until one is available.
+ * 
+ * @param queue Queue to pop from.
+ * @param message Message to pop into.
+ * 
+ * The calling thread yields the processor while the queue is empty.
+ * 
+ * @return void
+ */
+void spsc_queue_pop_wait(spsc_queue_t* queue, thread_message_t* message);
+
+#endif /* INC_SPSC_QUEUE */
@@ -0,0 +1,125 @@
+/**
+ * @file stats.h
+ * @author Emirhan Altunel
+ * @brief Header file for the stats module. Contains single-pass streaming statistics with mergeable states.
+ * @date 2026-10-19
+ */
+#ifndef INC_STATS
+#define INC_STATS
+
+#include <stdint.h>
+
+#define HISTOGRAM_MAX_BINS 64 /** Maximum number of bins of a histogram */
+#define HISTOGRAM_MIN 1       /** Lower bound of the default histogram */
+#define HISTOGRAM_MAX 10      /** Upper bound of the default histogram */
+#define KLL_CAPACITY 256      /** Number of items a level of the quantile sketch holds */
+#define KLL_LEVELS 32         /** Number of levels of the quantile sketch */
+
+/**
+ * @brief Count, mean, variance, minimum and maximum, updated with Welford's method.
+ */
+typedef struct running_stats_s {
+  int64_t count; /** Number of values */
+  double  mean;  /** Mean of the values */
+  double  m2;    /** Sum of squared differences from the mean */
+  int     min;   /** Minimum of the values */
+  int     max;   /** Maximum of the values */
+} running_stats_t;
+
+/**
+ * @brief Histogram with equal width bins between min and max, both inclusive.
+ */
+typedef struct histogram_s {
+  int     min;                        /** Lower bound of the first bin */
+  int     max;                        /** Upper bound of the last bin */
+  int     bins;                       /** Number of bins */
+  int64_t counts[HISTOGRAM_MAX_BINS]; /** Number of values of every bin */
+  int64_t underflow;                  /** Number of values below min */
+  int64_t overflow;                   /** Number of values above max */
+} histogram_t;
+
+/**
+ * @brief KLL style quantile sketch. An item of level i stands for 2^i values.
+ * 
+ * A full level is sorted and every other item is promoted to the next level, so memory stays
+ * constant and the rank error grows only logarithmically with the number of values.
+ */
+typedef struct kll_sketch_s {
+  int      items[KLL_LEVELS][KLL_CAPACITY]; /** Items of every level */
+  int      sizes[KLL_LEVELS];               /** Number of items of every level */
+  int64_t  count;                           /** Number of values the sketch stands for */
+  uint32_t random;                          /** State of the generator choosing the promoted items */
+} kll_sketch_t;
+
+/**
+ * @brief Every streaming statistic of a stream of integers.
+ */
+typedef struct stream_stats_s {
+  running_stats_t moments;   /** Count, mean, variance, minimum and maximum */
+  histogram_t     histogram; /** Histogram of the values */
+  kll_sketch_t    sketch;    /** Quantile sketch of the values */
+} stream_stats_t;
+
+/**
+ * @brief Initializes the streaming statistics.
+ * 
+ * @param stats Statistics to initialize.
+ * @param min Lower bound of the histogram.
+ * @param max Upper bound of the histogram.
+ * @param bins Number of bins of the histogram, at most HISTOGRAM_MAX_BINS.
+ * 
+ * @return 0 on success, -1 if the histogram bounds are invalid.
+ */
+int stream_stats_init(stream_stats_t* stats, int min, int max, int bins);
+
+/**
+ * @brief Updates the streaming statistics with a chunk of values.
+ * 
+ * @param stats Statistics to update.
+ * @param values Array of values.
+ * @param n Number of values in the array.
+ * 
+ * @return void
+ */
+void stream_stats_update(stream_stats_t* stats, const int* values, int n);
+
+/**
+ * @brief Merges the partial statistics of another stream.
+ * 
+ * @param stats Statistics to merge into.
+ * @param other Partial statistics to merge. Its histogram must have the same bounds and bins.
+ * 
+ * @return void
+ */
+void stream_stats_merge(stream_stats_t* stats, const stream_stats_t* other);
+
+/**
+ * @brief Returns the variance of the values.
+ * 
+ * @param stats Statistics to query.
+ * 
+ * @return The population variance, 0 if there are no values.
+ */
+double stream_stats_variance(const stream_stats_t* stats);
+
+/**
+ * @brief Returns an approximate quantile of the values.
+ * 
+ * @param stats Statistics to query.
+ * @param q Quantile between 0 and 1.
+ * 
+ * @return The smallest value whose approximate rank is at least q times the count.
+ */
+int stream_stats_quantile(const stream_stats_t* stats, double q);
+
+/**
+ * @brief Prints the statistics.
+ * 
+ * @param sender Name of the process that prints the statistics.
+ * @param stats Statistics to print.
+ * 
+ * @return void
+ */
+void stream_stats_print(const char* sender, const stream_stats_t* stats);
+
+#endif /* INC_STATS */
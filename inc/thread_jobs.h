@@ -0,0 +1,22 @@
+/**
+ * @file thread_jobs.h
+ * @brief Header file for the thread jobs module.
+ *
+ * This file contains the declarations for the thread engine, which runs the jobs of the
+ * first and second child as threads of a single process. The threads share the generated
+ * array and communicate through lock-free queues. The fork based engine in process_jobs.h
+ * stays as the isolated mode.
+ */
+#ifndef INC_THREAD_JOBS
+#define INC_THREAD_JOBS
+
+#include <options.h>
+
+#define FIRST_THREAD_NAME \
+  "\033[1;32m[First Thread]\033[0m" /** Name of the first worker thread */
+#define SECOND_THREAD_NAME \
+  "\033[1;33m[Second Thread]\033[0m" /** Name of the second worker thread */
+
+int thread_engine(const options_t* options);
+
+#endif /* INC_THREAD_JOBS */
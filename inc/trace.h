@@ -0,0 +1,150 @@
+/**
+ * @file trace.h
+ * @author Emirhan Altunel
+ * @brief Header file for the trace module. Contains binary recording of the fifo traffic and the helpers to replay it.
+ * @date 2026-10-19
+ */
+#ifndef INC_TRACE
+#define INC_TRACE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#define TRACE_MAGIC 0x31435254u       /** "TRC1" in little endian, first word of a trace file */
+#define TRACE_VERSION 1               /** Version of the trace format */
+#define TRACE_BUFFER_SIZE (1 << 16)   /** Number of bytes buffered before a trace is written */
+#define TRACE_MAX_IOV 8               /** Maximum number of buffers in a recorded message */
+#define TRACE_CHANNEL_FIFO1 1         /** Channel number of fifo1 */
+#define TRACE_CHANNEL_FIFO2 2         /** Channel number of fifo2 */
+
+/**
+ * @brief Enumeration for the replay speeds.
+ */
+typedef enum replay_speed_e {
+  REPLAY_ORIGINAL, /** Messages keep the gaps they were recorded with */
+  REPLAY_MAX,      /** Messages are sent back to back */
+} replay_speed_t;
+
+/**
+ * @brief Header at the start of a trace file.
+ */
+typedef struct trace_file_header_s {
+  uint32_t magic;   /** TRACE_MAGIC */
+  uint32_t version; /** TRACE_VERSION */
+} trace_file_header_t;
+
+/**
+ * @brief Header of a recorded message. The message bytes follow it.
+ */
+typedef struct trace_record_s {
+  uint64_t timestamp; /** CLOCK_MONOTONIC time of the message in nanoseconds */
+  uint32_t job;       /** Identifier of the job, the PID of the parent */
+  uint32_t sequence;  /** Index of the message among the messages of its sender */
+  uint16_t channel;   /** TRACE_CHANNEL_FIFO1 or TRACE_CHANNEL_FIFO2 */
+  uint16_t sender;    /** 0 for the parent, 1 or 2 for the children */
+  uint32_t size;      /** Number of message bytes */
+} trace_record_t;
+
+/**
+ * @brief Buffered trace writer of a process.
+ */
+typedef struct trace_s {
+  int           fd;                        /** File descriptor of the trace file, -1 if closed */
+  uint32_t      job;                       /** Identifier of the job */
+  uint32_t      sequence;                  /** Index of the next message */
+  size_t        used;                      /** Number of buffered bytes */
+  unsigned char buffer[TRACE_BUFFER_SIZE]; /** Records not written yet */
+} trace_t;
+
+/**
+ * @brief Opens a trace file for recording.
+ * 
+ * @param trace Writer to initialize.
+ * @param path Path of the trace file.
+ * @param job Identifier of the job.
+ * @param create 1 to truncate the file and write the file header, 0 to append to an existing trace.
+ * 
+ * Every process of a job opens the file on its own. Records are appended, so the writers do not
+ * overwrite each other.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int trace_open(trace_t* trace, const char* path, uint32_t job, int create);
+
+/**
+ * @brief Records a message.
+ * 
+ * @param trace Writer to use.
+ * @param channel Channel of the message.
+ * @param sender Sender of the message.
+ * @param iov Buffers of the message.
+ * @param iovcnt Number of buffers, at most TRACE_MAX_IOV.
+ * 
+ * A record that does not fit in the buffer is written right after the buffered part.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int trace_record(trace_t* trace, int channel, int sender,
+                 const struct iovec* iov, int iovcnt);
+
+/**
+ * @brief Writes the buffered records.
+ * 
+ * @param trace Writer to flush.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int trace_flush(trace_t* trace);
+
+/**
+ * @brief Flushes and closes a trace writer. Closing a closed writer does nothing.
+ * 
+ * @param trace Writer to close.
+ * 
+ * @return void
+ */
+void trace_close(trace_t* trace);
+
+/**
+ * @brief Opens a trace file for replay and checks its header.
+ * 
+ * @param path Path of the trace file.
+ * 
+ * @return File descriptor positioned at the first record, -1 on error.
+ */
+int trace_reader_open(const char* path);
+
+/**
+ * @brief Reads the header of the next record.
+ * 
+ * @param fd File descriptor of the trace file.
+ * @param record Record header to fill. The message bytes are read next from fd.
+ * 
+ * @return 1 if a record was read, 0 at the end of the trace, -1 on error.
+ */
+int trace_read_record(int fd, trace_record_t* record);
+
+/**
+ * @brief Returns the current CLOCK_MONOTONIC time.
+ * 
+ * @return Time in nanoseconds.
+ */
+uint64_t trace_now();
+
+/**
+ * @brief Sleeps until an offset from a start time or until a deadline expires.
+ * 
+ * @param start CLOCK_MONOTONIC start time in nanoseconds.
+ * @param offset Offset from the start time in nanoseconds.
+ * @param timer Deadline timer from deadline_start(), -1 for none.
+ * 
+ * The sleep ends at the exact time with clock_nanosleep(). With a deadline the whole milliseconds
+ * are spent polling the timer, and only the rest is slept.
+ * 
+ * @return 0 once the offset is reached, 1 if the deadline expired first, -1 on error.
+ */
+int trace_pace(uint64_t start, uint64_t offset, int timer);
+
+#endif /* INC_TRACE */
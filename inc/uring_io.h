@@ -0,0 +1,174 @@
+/**
+ * @file uring_io.h
+ * @author Emirhan Altunel
+ * @brief Header file for the io_uring module. Contains a minimal io_uring backend for channel and log traffic.
+ * @date 2026-10-19
+ */
+#ifndef INC_URING_IO
+#define INC_URING_IO
+
+#include <safe_io.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define URING_ENTRIES 32          /** Number of submission queue entries */
+#define URING_MAX_FILES 8         /** Maximum number of registered file descriptors */
+#define URING_LOG_SIZE (1 << 14)  /** Size of the buffer holding queued log lines */
+#define URING_CANCEL (~0ull)      /** User data of the request that cancels the operations in flight */
+
+/**
+ * @brief Read or write queued on the ring.
+ */
+typedef struct uring_op_s {
+  int    write; /** 1 for a write, 0 for a read */
+  int    fd;    /** File descriptor of the operation */
+  char*  buf;   /** Buffer of the operation */
+  size_t len;   /** Number of bytes to transfer */
+  size_t done;  /** Number of bytes transferred so far */
+  int    eof;   /** 1 if a read reached end of file */
+  int    res;   /** Result of the last completion */
+} uring_op_t;
+
+/**
+ * @brief State of an io_uring instance created with the raw system calls.
+ */
+typedef struct uring_s {
+  int                  fd;            /** File descriptor of the ring, -1 if unavailable */
+  unsigned*            sq_head;       /** Head of the submission queue */
+  unsigned*            sq_tail;       /** Tail of the submission queue */
+  unsigned*            sq_mask;       /** Mask of the submission queue */
+  unsigned*            sq_array;      /** Index array of the submission queue */
+  unsigned*            cq_head;       /** Head of the completion queue */
+  unsigned*            cq_tail;       /** Tail of the completion queue */
+  unsigned*            cq_mask;       /** Mask of the completion queue */
+  struct io_uring_sqe* sqes;          /** Submission queue entries */
+  struct io_uring_cqe* cqes;          /** Completion queue entries */
+  void*                sq_ring;       /** Mapping of the submission queue */
+  size_t               sq_ring_size;  /** Size of the submission queue mapping */
+  void*                cq_ring;       /** Mapping of the completion queue */
+  size_t               cq_ring_size;  /** Size of the completion queue mapping */
+  size_t               sqes_size;     /** Size of the submission queue entries mapping */
+  unsigned             entries;       /** Number of submission queue entries */
+  int                  files[URING_MAX_FILES]; /** Registered file descriptors */
+  int                  file_count;    /** Number of registered file descriptors */
+  char*                buffer;        /** Registered buffer, NULL if there is none */
+  size_t               buffer_size;   /** Size of the registered buffer */
+  uring_op_t           ops[URING_ENTRIES]; /** Queued operations in submission order */
+  int                  op_count;      /** Number of queued operations */
+  int                  completed;     /** 1 if the operations were completed by the last submission */
+  char                 log[URING_LOG_SIZE]; /** Copies of the queued log lines */
+  size_t               log_used;      /** Number of used bytes of the log buffer */
+} uring_t;
+
+/**
+ * @brief Creates an io_uring instance.
+ * 
+ * @param ring Ring to initialize.
+ * 
+ * @return 0 on success, -1 if io_uring is not available.
+ */
+int uring_init(uring_t* ring);
+
+/**
+ * @brief Destroys an io_uring instance.
+ * 
+ * @param ring Ring to destroy.
+ * 
+ * Queued operations are submitted before the ring is destroyed.
+ * 
+ * @return void
+ */
+void uring_destroy(uring_t* ring);
+
+/**
+ * @brief Registers file descriptors with the ring.
+ * 
+ * @param ring Ring to register with.
+ * @param fds File descriptors to register.
+ * @param count Number of file descriptors.
+ * 
+ * Operations on registered file descriptors skip the file lookup of every request.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int uring_register_files(uring_t* ring, const int* fds, int count);
+
+/**
+ * @brief Registers a buffer with the ring.
+ * 
+ * @param ring Ring to register with.
+ * @param buf Buffer to register.
+ * @param len Size of the buffer.
+ * 
+ * Operations inside the registered buffer use the fixed buffer opcodes, so the pages are not
+ * mapped again for every request. A previously registered buffer is unregistered.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int uring_register_buffer(uring_t* ring, void* buf, size_t len);
+
+/**
+ * @brief Queues a read or a write.
+ * 
+ * @param ring Ring to queue on.
+ * @param write 1 for a write, 0 for a read.
+ * @param fd File descriptor of the operation.
+ * @param buf Buffer of the operation. It must stay valid until the ring is submitted.
+ * @param len Number of bytes to transfer.
+ * 
+ * Queued operations are executed in order. If the queue is full it is submitted first.
+ * 
+ * @return Index of the operation until the next submission, -1 on error.
+ */
+int uring_queue(uring_t* ring, int write, int fd, void* buf, size_t len);
+
+/**
+ * @brief Submits the queued operations and waits until every one is complete.
+ * 
+ * @param ring Ring to submit.
+ * 
+ * The operations are linked, so they run in the order they were queued. Short transfers are
+ * resubmitted until they complete. A read stops early only at end of file.
+ * 
+ * @return 0 on success, -1 on error.
+ */
+int uring_submit_wait(uring_t* ring);
+
+/**
+ * @brief Submits the queued operations and waits for them with a caller supplied function.
+ * 
+ * @param ring Ring to submit.
+ * @param wait Function called with the ring file descriptor while operations are in flight.
+ * 
+ * Same as uring_submit_wait() but the process does not block in the kernel, so the wait can also
+ * watch a deadline or other events. If wait gives up, the operations in flight are cancelled.
+ * 
+ * @return 0 on success, -1 on error or if the wait gave up.
+ */
+int uring_submit_poll(uring_t* ring, io_wait_t wait);
+
+/**
+ * @brief Returns the number of bytes an operation of the last submission transferred.
+ * 
+ * @param ring Ring that was submitted.
+ * @param op Index returned by uring_queue().
+ * 
+ * @return Number of bytes transferred.
+ */
+ssize_t uring_done(const uring_t* ring, int op);
+
+/**
+ * @brief Queues a log line on the ring.
+ * 
+ * @param ring Ring to queue on.
+ * @param fd File descriptor of the log.
+ * @param buf Log line to write. It is copied, so it may be reused right away.
+ * @param len Length of the log line.
+ * 
+ * The line is written with the next submission, which batches log output with channel traffic.
+ * 
+ * @return len on success, -1 on error.
+ */
+ssize_t uring_queue_log(uring_t* ring, int fd, const void* buf, size_t len);
+
+#endif /* INC_URING_IO */
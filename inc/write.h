@@ -7,6 +7,9 @@
 #ifndef INC_WRITE
 #define INC_WRITE
 
+#include <stddef.h>
+#include <sys/types.h>
+
 /**
  * @brief Enumeration for different styles of text.
  */
@@ -74,6 +77,20 @@ void write_int(char* buffer, int n, int* index, int len);
  */
 void write_int_array(char* buffer, int* arr, int n, int* index, int len);
 
+/**
+ * @brief Writes a floating point number with three decimals to the buffer.
+ * 
+ * @param buffer Buffer to write to.
+ * @param x Number to write.
+ * @param index Index of the buffer.
+ * @param len Length of the buffer.
+ * 
+ * If the number does not fit in the buffer, the function does nothing.
+ * 
+ * @return void
+ */
+void write_fixed(char* buffer, double x, int* index, int len);
+
 /**
  * @brief Writes a style to the buffer.
  * 
@@ -88,6 +105,20 @@ void write_int_array(char* buffer, int* arr, int n, int* index, int len);
  */
 void write_style(char* buffer, style_t style, int* index, int len);
 
+/**
+ * @brief Function that writes a finished log line to a file descriptor.
+ */
+typedef ssize_t (*write_sink_t)(int fd, const void* buf, size_t count);
+
+/**
+ * @brief Sets the function that writes the log lines of process_safe_write().
+ * 
+ * @param sink Function to use, NULL to write directly with write_all().
+ * 
+ * @return void
+ */
+void set_write_sink(write_sink_t sink);
+
 /**
  * @brief Writes a formatted string to the file descriptor.
  * 
@@ -98,6 +129,9 @@ void write_style(char* buffer, style_t style, int* index, int len);
  * The function writes the formatted string to the file descriptor.
  * It uses a buffer to write to the file descriptor. 
  * It is process-safe.
+ * %f prints a double with three decimals.
+ * A string argument that does not fit in the buffer moves the line to a heap buffer, so it is not truncated
+ * and the whole line is still written at once.
  * 
  * @return void
  */
@@ -110,7 +144,7 @@ void process_safe_write(int fd, const char* format, ...);
  * 
  * The function converts the string to an unsigned integer.
  * 
- * @return The unsigned integer.
+ * @return The unsigned integer, -1 if the string is not a number or is above INT_MAX.
  */
 int str2uint(const char* str);
 
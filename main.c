@@ -2,14 +2,19 @@
 
 #include <fcntl.h>
 #include <macros.h>
+#include <options.h>
+#include <pipeline.h>
 #include <process_jobs.h>
+#include <scheduler.h>
 #include <signal.h>
 #include <sys/wait.h>
+#include <thread_jobs.h>
 #include <unistd.h>
 #include <write.h>
 
-int          child_count = 2;         // Number of children
-static pid_t pid[2]      = {-1, -1};  // PIDs of children
+int                   child_count   = 2;         // Number of children
+volatile sig_atomic_t job_cancelled = 0;         // 1 once the job was cancelled
+static pid_t          pid[2]        = {-1, -1};  // PIDs of children
 
 /**
  * @brief Kill all children
@@ -31,6 +36,9 @@ int kill_children() {
 /**
  * @brief Signal handler for SIGCHLD
  * 
+ * While the parent runs its job SIGCHLD is blocked and the parent calls the
+ * handler itself whenever its signal file descriptor reports an exit.
+ * 
  * @param signal The signal number
  */
 void sigchld_handler(int signal) {
@@ -47,6 +55,9 @@ void sigchld_handler(int signal) {
     if (return_value == 0) {
       process_safe_write(1, "%s Child with PID %d exited with status %d\n",
                          PARENT_NAME, pid_child, return_value);
+    } else if (job_cancelled) {
+      process_safe_write(1, "%s Child with PID %d was cancelled\n",
+                         PARENT_NAME, pid_child);
     } else {
       if (return_value != SELF_EXIT)
         process_safe_write(1,
@@ -69,34 +80,42 @@ void sigchld_handler(int signal) {
 }
 
 int main(int argc, char* argv[]) {
-  if (argc != 1 && argc != 2) {
-    process_safe_write(2,
-                       "Usage: %s [0 < number of random numbers < 10]\nDefault "
-                       "number of random numbers is 5\n",
-                       argv[0]);
+  options_t options;
+  if (parse_options(argc, argv, &options) == -1) {
+    print_usage(argv[0]);
     return 1;
   }
-  int numberOfRandomNumbers = argc == 1 ? 5 : str2uint(argv[1]);
-  ASSERT(numberOfRandomNumbers > 0 && numberOfRandomNumbers < 11, PARENT_NAME,
-         " Number of random numbers must be between 0 and 11\n", 1);
+  int numberOfRandomNumbers = options.numberOfRandomNumbers;
+  ASSERT(numberOfRandomNumbers > 0 &&
+             numberOfRandomNumbers <= MAX_RANDOM_NUMBERS,
+         PARENT_NAME, " Number of random numbers is out of range\n", 1);
+
+  if (options.pipeline || options.pipeline_file)
+    return job_exit_status(pipeline_engine(&options));
+  if (options.threads) return thread_engine(&options) == 0 ? 0 : 1;
+  if (options.workers) return job_exit_status(scheduler_engine(&options));
 
   ASSERT(open_fifos() == 0, PARENT_NAME, "Error opening fifos\n", 1);
 
   if ((pid[0] = fork()) == 0) {
-    return first_child();
+    return first_child(&options);
   } else if ((pid[1] = fork()) == 0) {
-    return second_child();
+    return second_child(&options);
   } else if (pid[0] == -1 || pid[1] == -1) {
     process_safe_write(2, "%s Error forking\n", PARENT_NAME);
     process_safe_write(1, "%s Killing children if any\n", PARENT_NAME);
     kill_children();
     ASSERT(unlink_fifos() == 0, PARENT_NAME, "Error unlinking fifos\n", 2);
   } else {
-    if (parent(numberOfRandomNumbers) == -1) {
+    job_result_t result = parent(&options);
+    if (result == JOB_FAILED) {
       process_safe_write(2, "%s Error in parent\n", PARENT_NAME);
       process_safe_write(1, "%s Killing children\n", PARENT_NAME);
       kill_children();
       ASSERT(unlink_fifos() == 0, PARENT_NAME, "Error unlinking fifos\n", 2);
+    } else if (result == JOB_TIMEOUT) {
+      ASSERT(unlink_fifos() == 0, PARENT_NAME, "Error unlinking fifos\n", 2);
+      return TIMEOUT_EXIT;
     }
   }
 
@@ -0,0 +1,167 @@
+#define _GNU_SOURCE
+
+#include <affinity.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <safe_io.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <write.h>
+
+#define MPOL_LOCAL_POLICY 4 /** MPOL_LOCAL of the set_mempolicy system call */
+#define CACHE_LEVELS 8      /** Number of cache index directories to look at */
+
+/**
+ * @brief Parse an unsigned integer at the start of a string
+ * 
+ * @param str The string, advanced past the digits
+ * @return int The integer, -1 if there are no digits
+ */
+static int parse_number(const char** str) {
+  int value = -1;
+  while (**str >= '0' && **str <= '9') {
+    value = (value == -1 ? 0 : value * 10) + (**str - '0');
+    if (value >= CPU_SETSIZE) return -1;
+    (*str)++;
+  }
+  return value;
+}
+
+/**
+ * @brief Check whether a CPU is already in a list
+ * 
+ * @param cpus The list
+ * @param count The number of CPUs in the list
+ * @param cpu The CPU
+ * @return int 1 if the CPU is in the list, 0 otherwise
+ */
+static int contains(const int* cpus, int count, int cpu) {
+  for (int i = 0; i < count; i++)
+    if (cpus[i] == cpu) return 1;
+  return 0;
+}
+
+int parse_cpu_list(const char* str, int* cpus, int max) {
+  int count = 0;
+  while (*str != '\0') {
+    int first = parse_number(&str);
+    int last  = first;
+    if (first == -1) return -1;
+    if (*str == '-') {
+      str++;
+      last = parse_number(&str);
+      if (last < first) return -1;
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      if (count == max) return -1;
+      cpus[count++] = cpu;
+    }
+    if (*str == '\0') break;
+    if (*str != ',' || *++str == '\0') return -1;
+  }
+  return count;
+}
+
+/**
+ * @brief Read the CPUs that share the last level cache of a CPU
+ * 
+ * The text buffer fits a list of max CPUs written one by one.
+ * 
+ * @param cpu The CPU
+ * @param cpus The array that receives the CPUs
+ * @param max The capacity of the array
+ * @return int The number of CPUs, -1 if the topology is unknown
+ */
+static int read_cache_siblings(int cpu, int* cpus, int max) {
+  int    count = -1;
+  size_t size  = (size_t)max * 5 + 2;
+  char*  list  = malloc(size);
+  if (list == NULL) return -1;
+  for (int level = 0; level < CACHE_LEVELS; level++) {
+    char path[128] = {0};
+    int  index     = 0;
+    write_string(path, "/sys/devices/system/cpu/cpu", &index, sizeof(path));
+    write_int(path, cpu, &index, sizeof(path));
+    write_string(path, "/cache/index", &index, sizeof(path));
+    write_int(path, level, &index, sizeof(path));
+    write_string(path, "/shared_cpu_list", &index, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) break;
+    ssize_t n = read_all(fd, list, size - 1);
+    close(fd);
+    if (n <= 0) break;
+    while (n > 0 && (list[n - 1] == '\n' || list[n - 1] == ' ')) n--;
+    list[n] = '\0';
+    int siblings = parse_cpu_list(list, cpus, max);
+    if (siblings != -1) count = siblings;
+  }
+  free(list);
+  return count;
+}
+
+int auto_cpu_list(int* cpus, int max) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == -1) return -1;
+
+  int count = 0;
+  int first = -1;
+  for (int cpu = 0; cpu < CPU_SETSIZE && first == -1; cpu++)
+    if (CPU_ISSET(cpu, &allowed)) first = cpu;
+  if (first == -1 || max < 1) return -1;
+  cpus[count++] = first;
+
+  /**
+   * @brief Size the sibling list for every configured CPU
+   * 
+   */
+  long configured = sysconf(_SC_NPROCESSORS_CONF);
+  int  capacity   = configured > 0 && configured < CPU_SETSIZE
+                        ? (int)configured
+                        : CPU_SETSIZE;
+  int* siblings   = malloc(capacity * sizeof(int));
+  if (siblings == NULL) return -1;
+  int sibling_count = read_cache_siblings(first, siblings, capacity);
+  if (sibling_count == -1)
+    process_safe_write(2,
+                       "Cache topology of CPU %d is unknown, placing on the "
+                       "allowed CPUs in order\n",
+                       first);
+  for (int i = 0; i < sibling_count && count < max; i++)
+    if (CPU_ISSET(siblings[i], &allowed) && !contains(cpus, count, siblings[i]))
+      cpus[count++] = siblings[i];
+  free(siblings);
+
+  for (int cpu = 0; cpu < CPU_SETSIZE && count < max; cpu++)
+    if (CPU_ISSET(cpu, &allowed) && !contains(cpus, count, cpu))
+      cpus[count++] = cpu;
+  return count;
+}
+
+int place_self(const int* cpus, int count, int role, const char* name) {
+  if (count <= 0) return -1;
+  int       cpu = cpus[role % count];
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) == -1) {
+    process_safe_write(2, "%s %eError pinning to CPU %d: %s\n", name, cpu,
+                       strerror(errno));
+    return PLACEMENT_FAILED;
+  }
+  if (syscall(SYS_set_mempolicy, MPOL_LOCAL_POLICY, NULL, 0) == -1)
+    process_safe_write(2, "%s Error setting the local memory policy: %s\n",
+                       name, strerror(errno));
+  return cpu;
+}
+
+int allowed_cpu_count() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == -1) return 1;
+  int count = CPU_COUNT(&allowed);
+  return count > 0 ? count : 1;
+}
@@ -0,0 +1,100 @@
+#define _GNU_SOURCE
+
+#include <arena.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define ARENA_ALIGNMENT 16 /** Alignment of every allocation */
+
+/**
+ * @brief Round a size up to a multiple of a power of two
+ * 
+ * @param size The size
+ * @param alignment The power of two
+ * @return size_t The rounded size
+ */
+static size_t align_up(size_t size, size_t alignment) {
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Map a new block that can hold at least size bytes
+ * 
+ * Large blocks of an arena with huge pages are mapped with MAP_HUGETLB. If no huge page is reserved
+ * they fall back to normal pages with a transparent huge page hint.
+ * 
+ * @param arena The arena
+ * @param size The number of bytes the block must hold
+ * @return arena_block_t* The block, NULL on error
+ */
+static arena_block_t* map_block(arena_t* arena, size_t size) {
+  size_t header = align_up(sizeof(arena_block_t), ARENA_ALIGNMENT);
+  size_t total  = align_up(header + size, ARENA_BLOCK_SIZE);
+  void*  memory = MAP_FAILED;
+
+  if (arena->huge_pages && total >= ARENA_HUGE_PAGE_SIZE) {
+    total  = align_up(total, ARENA_HUGE_PAGE_SIZE);
+    memory = mmap(NULL, total, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+  if (memory == MAP_FAILED) {
+    memory = mmap(NULL, total, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return NULL;
+    if (arena->huge_pages) madvise(memory, total, MADV_HUGEPAGE);
+  }
+
+  arena_block_t* block = (arena_block_t*)memory;
+  block->next          = NULL;
+  block->size          = total;
+  block->used          = header;
+  return block;
+}
+
+void arena_init(arena_t* arena, int huge_pages) {
+  arena->blocks     = NULL;
+  arena->current    = NULL;
+  arena->huge_pages = huge_pages;
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+  size = align_up(size > 0 ? size : 1, ARENA_ALIGNMENT);
+
+  arena_block_t* block = arena->current;
+  while (block != NULL && block->size - block->used < size) block = block->next;
+  if (block == NULL) {
+    block = map_block(arena, size);
+    if (block == NULL) return NULL;
+    block->next   = arena->blocks;
+    arena->blocks = block;
+  }
+  arena->current = block;
+
+  void* memory = (char*)block + block->used;
+  block->used += size;
+  return memory;
+}
+
+char* arena_strdup(arena_t* arena, const char* s) {
+  char* p = (char*)arena_alloc(arena, strlen(s) + 1);
+  if (p != NULL) strcpy(p, s);
+  return p;
+}
+
+void arena_reset(arena_t* arena) {
+  size_t header = align_up(sizeof(arena_block_t), ARENA_ALIGNMENT);
+  for (arena_block_t* block = arena->blocks; block != NULL; block = block->next)
+    block->used = header;
+  arena->current = arena->blocks;
+}
+
+void arena_destroy(arena_t* arena) {
+  arena_block_t* block = arena->blocks;
+  while (block != NULL) {
+    arena_block_t* next = block->next;
+    munmap(block, block->size);
+    block = next;
+  }
+  arena->blocks  = NULL;
+  arena->current = NULL;
+}
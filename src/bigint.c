@@ -0,0 +1,353 @@
+#include <bigint.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PRODUCT_LEAF_SIZE 16    /** Number of factors multiplied directly at a leaf of the product tree */
+#define DECIMAL_BASE 1000000000 /** Largest power of ten that fits in a limb */
+#define DECIMAL_DIGITS 9        /** Number of decimal digits of a DECIMAL_BASE chunk */
+
+/**
+ * @brief Arguments of a product tree branch run in its own thread
+ */
+typedef struct product_task_s {
+  bigint_t*  result;
+  const int* numbers;
+  int        n;
+  int        threads;
+  int        status;
+} product_task_t;
+
+/**
+ * @brief Drop the most significant zero limbs
+ * 
+ * @param n The big integer
+ */
+static void normalize(bigint_t* n) {
+  while (n->size > 0 && n->limbs[n->size - 1] == 0) n->size--;
+}
+
+/**
+ * @brief Add a limb array into another one
+ * 
+ * @param r The array to add into
+ * @param rn The number of limbs of r, at least an
+ * @param a The array to add
+ * @param an The number of limbs of a
+ * @return uint32_t The carry out of r
+ */
+static uint32_t add_limbs(uint32_t* r, int rn, const uint32_t* a, int an) {
+  uint64_t carry = 0;
+  int      i     = 0;
+  for (; i < an; i++) {
+    carry += (uint64_t)r[i] + a[i];
+    r[i]   = (uint32_t)carry;
+    carry >>= 32;
+  }
+  for (; carry && i < rn; i++) {
+    carry += r[i];
+    r[i]   = (uint32_t)carry;
+    carry >>= 32;
+  }
+  return (uint32_t)carry;
+}
+
+/**
+ * @brief Subtract a limb array from another one that is not smaller
+ * 
+ * @param r The array to subtract from
+ * @param rn The number of limbs of r, at least an
+ * @param a The array to subtract
+ * @param an The number of limbs of a
+ */
+static void sub_limbs(uint32_t* r, int rn, const uint32_t* a, int an) {
+  int64_t borrow = 0;
+  int     i      = 0;
+  for (; i < an; i++) {
+    int64_t diff = (int64_t)r[i] - a[i] - borrow;
+    borrow       = diff < 0;
+    r[i]         = (uint32_t)diff;
+  }
+  for (; borrow && i < rn; i++) {
+    borrow = r[i] == 0;
+    r[i]--;
+  }
+}
+
+/**
+ * @brief Schoolbook multiplication
+ * 
+ * @param r The result with an + bn limbs
+ * @param a The first factor
+ * @param an The number of limbs of a
+ * @param b The second factor
+ * @param bn The number of limbs of b
+ */
+static void mul_school(uint32_t* r, const uint32_t* a, int an,
+                       const uint32_t* b, int bn) {
+  memset(r, 0, (an + bn) * sizeof(uint32_t));
+  for (int i = 0; i < an; i++) {
+    uint64_t carry = 0;
+    for (int j = 0; j < bn; j++) {
+      carry += (uint64_t)a[i] * b[j] + r[i + j];
+      r[i + j] = (uint32_t)carry;
+      carry >>= 32;
+    }
+    r[i + bn] = (uint32_t)carry;
+  }
+}
+
+/**
+ * @brief Karatsuba multiplication
+ * 
+ * Falls back to schoolbook multiplication below KARATSUBA_THRESHOLD limbs and splits
+ * very unbalanced factors into pieces of the size of the smaller one.
+ * 
+ * @param r The result with an + bn limbs
+ * @param a The first factor
+ * @param an The number of limbs of a
+ * @param b The second factor
+ * @param bn The number of limbs of b
+ * @return int 0 on success, -1 on error
+ */
+static int mul_karatsuba(uint32_t* r, const uint32_t* a, int an,
+                         const uint32_t* b, int bn) {
+  if (an < bn) {
+    const uint32_t* t  = a;
+    int             tn = an;
+    a                  = b;
+    an                 = bn;
+    b                  = t;
+    bn                 = tn;
+  }
+  if (bn < KARATSUBA_THRESHOLD) {
+    mul_school(r, a, an, b, bn);
+    return 0;
+  }
+
+  if (2 * bn <= an) {
+    uint32_t* piece = (uint32_t*)malloc(2 * bn * sizeof(uint32_t));
+    if (piece == NULL) return -1;
+    memset(r, 0, (an + bn) * sizeof(uint32_t));
+    for (int offset = 0; offset < an; offset += bn) {
+      int len = an - offset < bn ? an - offset : bn;
+      if (mul_karatsuba(piece, a + offset, len, b, bn) == -1) {
+        free(piece);
+        return -1;
+      }
+      add_limbs(r + offset, an + bn - offset, piece, len + bn);
+    }
+    free(piece);
+    return 0;
+  }
+
+  /**
+   * @brief a = a1 * B^m + a0 and b = b1 * B^m + b0
+   * a * b = z2 * B^2m + ((a0 + a1)(b0 + b1) - z2 - z0) * B^m + z0
+   * 
+   */
+  int       m   = an / 2;
+  int       sn  = an - m + 1;
+  uint32_t* tmp = (uint32_t*)calloc(4 * sn, sizeof(uint32_t));
+  if (tmp == NULL) return -1;
+  uint32_t* sa = tmp;
+  uint32_t* sb = tmp + sn;
+  uint32_t* z1 = tmp + 2 * sn;
+
+  if (mul_karatsuba(r, a, m, b, m) == -1 ||
+      mul_karatsuba(r + 2 * m, a + m, an - m, b + m, bn - m) == -1)
+    goto Error;
+
+  memcpy(sa, a + m, (an - m) * sizeof(uint32_t));
+  add_limbs(sa, sn, a, m);
+  memcpy(sb, b, m * sizeof(uint32_t));
+  add_limbs(sb, sn, b + m, bn - m);
+  if (mul_karatsuba(z1, sa, sn, sb, sn) == -1) goto Error;
+  sub_limbs(z1, 2 * sn, r, 2 * m);
+  sub_limbs(z1, 2 * sn, r + 2 * m, an + bn - 2 * m);
+
+  int z1n = 2 * sn;
+  while (z1n > 0 && z1[z1n - 1] == 0) z1n--;
+  add_limbs(r + m, an + bn - m, z1, z1n);
+  free(tmp);
+  return 0;
+
+Error:
+  free(tmp);
+  return -1;
+}
+
+int bigint_init(bigint_t* n, uint32_t value) {
+  n->limbs = (uint32_t*)malloc(sizeof(uint32_t));
+  if (n->limbs == NULL) return -1;
+  n->limbs[0] = value;
+  n->size     = 1;
+  normalize(n);
+  return 0;
+}
+
+void bigint_free(bigint_t* n) {
+  free(n->limbs);
+  n->limbs = NULL;
+  n->size  = 0;
+}
+
+int bigint_mul(bigint_t* result, const bigint_t* a, const bigint_t* b) {
+  int size      = a->size + b->size;
+  result->limbs = (uint32_t*)malloc((size > 0 ? size : 1) * sizeof(uint32_t));
+  if (result->limbs == NULL) return -1;
+  result->size = size;
+  if (a->size == 0 || b->size == 0) {
+    result->size = 0;
+    return 0;
+  }
+  if (mul_karatsuba(result->limbs, a->limbs, a->size, b->limbs, b->size) ==
+      -1) {
+    bigint_free(result);
+    return -1;
+  }
+  normalize(result);
+  return 0;
+}
+
+/**
+ * @brief Multiply the factors of a leaf of the product tree one by one
+ * 
+ * @param result The product, must not be initialized
+ * @param numbers The factors
+ * @param n The number of factors
+ * @return int 0 on success, -1 on error
+ */
+static int product_leaf(bigint_t* result, const int* numbers, int n) {
+  result->limbs = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+  if (result->limbs == NULL) return -1;
+  result->limbs[0] = 1;
+  result->size     = 1;
+  for (int i = 0; i < n; i++) {
+    uint64_t carry = 0;
+    for (int j = 0; j < result->size; j++) {
+      carry += (uint64_t)result->limbs[j] * (uint32_t)numbers[i];
+      result->limbs[j] = (uint32_t)carry;
+      carry >>= 32;
+    }
+    if (carry) result->limbs[result->size++] = (uint32_t)carry;
+  }
+  normalize(result);
+  return 0;
+}
+
+static void* product_thread(void* arg);
+
+/**
+ * @brief Multiply a range of the factors as a balanced product tree
+ * 
+ * While threads is above one, the left half is computed by a new thread.
+ * 
+ * @param result The product, must not be initialized
+ * @param numbers The factors
+ * @param n The number of factors
+ * @param threads The number of threads that may work on this range
+ * @return int 0 on success, -1 on error
+ */
+static int product_tree(bigint_t* result, const int* numbers, int n,
+                        int threads) {
+  if (n <= PRODUCT_LEAF_SIZE) return product_leaf(result, numbers, n);
+
+  int            half  = n / 2;
+  bigint_t       left  = {0};
+  bigint_t       right = {0};
+  product_task_t task  = {&left, numbers, half, threads / 2, -1};
+  pthread_t      thread;
+  int            spawned = 0;
+  if (threads > 1)
+    spawned = pthread_create(&thread, NULL, product_thread, &task) == 0;
+  if (!spawned) task.status = product_tree(&left, numbers, half, 1);
+
+  int status = product_tree(&right, numbers + half, n - half,
+                            spawned ? threads - threads / 2 : 1);
+  if (spawned) pthread_join(thread, NULL);
+  if (status == 0 && task.status == 0)
+    status = bigint_mul(result, &left, &right);
+  else
+    status = -1;
+  bigint_free(&left);
+  bigint_free(&right);
+  return status;
+}
+
+/**
+ * @brief Entry point of a product tree branch run in its own thread
+ * 
+ * @param arg The product_task_t of the branch
+ * @return void* NULL
+ */
+static void* product_thread(void* arg) {
+  product_task_t* task = (product_task_t*)arg;
+  task->status = product_tree(task->result, task->numbers, task->n,
+                              task->threads);
+  return NULL;
+}
+
+int bigint_product(bigint_t* result, const int* numbers, int n, int threads) {
+  return product_tree(result, numbers, n, threads < 1 ? 1 : threads);
+}
+
+int bigint_add_uint(bigint_t* n, uint32_t value) {
+  uint32_t* limbs =
+      (uint32_t*)realloc(n->limbs, (n->size + 1) * sizeof(uint32_t));
+  if (limbs == NULL) return -1;
+  n->limbs          = limbs;
+  n->limbs[n->size] = 0;
+  add_limbs(n->limbs, n->size + 1, &value, 1);
+  n->size++;
+  normalize(n);
+  return 0;
+}
+
+char* bigint_to_string(const bigint_t* n) {
+  int       size   = n->size;
+  uint32_t* limbs  = (uint32_t*)malloc((size > 0 ? size : 1) * sizeof(uint32_t));
+  uint32_t* chunks = (uint32_t*)malloc((size + 1) * 2 * sizeof(uint32_t));
+  char*     str    = (char*)malloc((size + 1) * 2 * DECIMAL_DIGITS + 1);
+  if (limbs == NULL || chunks == NULL || str == NULL) goto Error;
+  memcpy(limbs, n->limbs, size * sizeof(uint32_t));
+
+  /**
+   * @brief Divide by 10^9 until the quotient is zero, collecting the remainders
+   * 
+   */
+  int count = 0;
+  do {
+    uint64_t remainder = 0;
+    for (int i = size - 1; i >= 0; i--) {
+      uint64_t current = remainder << 32 | limbs[i];
+      limbs[i]         = (uint32_t)(current / DECIMAL_BASE);
+      remainder        = current % DECIMAL_BASE;
+    }
+    while (size > 0 && limbs[size - 1] == 0) size--;
+    chunks[count++] = (uint32_t)remainder;
+  } while (size > 0);
+
+  int index = 0;
+  for (int i = count - 1; i >= 0; i--) {
+    char digits[DECIMAL_DIGITS];
+    for (int j = DECIMAL_DIGITS - 1; j >= 0; j--) {
+      digits[j] = chunks[i] % 10 + '0';
+      chunks[i] /= 10;
+    }
+    int j = 0;
+    if (i == count - 1)
+      while (j < DECIMAL_DIGITS - 1 && digits[j] == '0') j++;
+    for (; j < DECIMAL_DIGITS; j++) str[index++] = digits[j];
+  }
+  str[index] = '\0';
+  free(limbs);
+  free(chunks);
+  return str;
+
+Error:
+  free(limbs);
+  free(chunks);
+  free(str);
+  return NULL;
+}
@@ -0,0 +1,44 @@
+#define _GNU_SOURCE
+
+#include <deadline.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+int deadline_start(int milliseconds) {
+  int timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (timer == -1) return -1;
+  struct itimerspec expiry = {{0, 0}, {0, 0}};
+  expiry.it_value.tv_sec   = milliseconds / 1000;
+  expiry.it_value.tv_nsec  = (milliseconds % 1000) * 1000000L;
+  if (timerfd_settime(timer, 0, &expiry, NULL) == -1) {
+    close(timer);
+    return -1;
+  }
+  return timer;
+}
+
+int deadline_wait(int timer, int fd, int timeout) {
+  struct pollfd fds[2] = {{timer, POLLIN, 0}, {fd, POLLIN, 0}};
+  if (poll(fds, 2, timeout) == -1) return errno == EINTR ? 0 : -1;
+  if (!(fds[0].revents & POLLIN)) return 0;
+
+  /** @brief Consume the expiration so the timer is not reported again */
+  uint64_t expirations;
+  if (read(timer, &expirations, sizeof(expirations)) == -1 && errno != EAGAIN)
+    return -1;
+  return 1;
+}
+
+int job_exit_status(job_result_t result) {
+  switch (result) {
+    case JOB_OK:
+      return 0;
+    case JOB_TIMEOUT:
+      return TIMEOUT_EXIT;
+    default:
+      return 1;
+  }
+}
@@ -0,0 +1,268 @@
+#include <encoding.h>
+#include <operations.h>
+#include <string.h>
+
+/**
+ * @brief Zigzag map a signed integer, so small magnitudes get small codes
+ * 
+ * @param value The integer
+ * @return uint32_t The zigzag code
+ */
+static uint32_t zigzag_encode(int value) {
+  return ((uint32_t)value << 1) ^ (value < 0 ? 0xFFFFFFFFu : 0);
+}
+
+/**
+ * @brief Undo the zigzag mapping
+ * 
+ * @param code The zigzag code
+ * @return int The integer
+ */
+static int zigzag_decode(uint32_t code) {
+  return (int)((code >> 1) ^ (0u - (code & 1)));
+}
+
+/**
+ * @brief Number of bytes of the varint of a code
+ * 
+ * @param code The code
+ * @return int The number of bytes
+ */
+static int varint_length(uint32_t code) {
+  int size = 1;
+  while (code >= 0x80) {
+    code >>= 7;
+    size++;
+  }
+  return size;
+}
+
+const char* encoding_name(int encoding) {
+  switch (encoding) {
+    case ENCODING_RAW:
+      return "raw";
+    case ENCODING_BITPACK:
+      return "bitpack";
+    case ENCODING_VARINT:
+      return "varint";
+    case ENCODING_AUTO:
+      return "auto";
+    default:
+      return "unknown";
+  }
+}
+
+int parse_encoding(const char* name) {
+  for (int encoding = ENCODING_RAW; encoding <= ENCODING_AUTO; encoding++)
+    if (strcmp(name, encoding_name(encoding)) == 0) return encoding;
+  return -1;
+}
+
+size_t encoded_size_bound(int n) { return (size_t)n * 5 + 8; }
+
+int encode_numbers(const int* numbers, int n, int encoding,
+                   payload_header_t* header, unsigned char* out) {
+  int min = numbers[0];
+  int max = numbers[0];
+  for (int i = 1; i < n; i++) {
+    if (numbers[i] < min) min = numbers[i];
+    if (numbers[i] > max) max = numbers[i];
+  }
+  uint64_t range = (uint64_t)((int64_t)max - min);
+  int      bits  = 0;
+  while (bits < 32 && (range >> bits) != 0) bits++;
+
+  size_t raw_size     = (size_t)n * sizeof(int);
+  size_t bitpack_size = ((size_t)n * bits + 7) / 8;
+  size_t varints_size = 0;
+  if (encoding == ENCODING_VARINT || encoding == ENCODING_AUTO)
+    for (int i = 0; i < n; i++)
+      varints_size += varint_length(zigzag_encode(numbers[i]));
+
+  if (encoding == ENCODING_AUTO) {
+    encoding = ENCODING_RAW;
+    if (bitpack_size < raw_size) encoding = ENCODING_BITPACK;
+    if (varints_size < (encoding == ENCODING_RAW ? raw_size : bitpack_size))
+      encoding = ENCODING_VARINT;
+  }
+
+  header->encoding = encoding;
+  header->count    = n;
+  header->base     = min;
+  header->bits     = bits;
+  switch (encoding) {
+    case ENCODING_RAW:
+      memcpy(out, numbers, raw_size);
+      header->size = raw_size;
+      return 0;
+    case ENCODING_BITPACK: {
+      uint64_t buffer = 0;
+      int      count  = 0;
+      size_t   size   = 0;
+      for (int i = 0; i < n; i++) {
+        buffer |= (uint64_t)((uint32_t)numbers[i] - (uint32_t)min) << count;
+        count += bits;
+        for (; count >= 8; count -= 8, buffer >>= 8) out[size++] = buffer & 0xFF;
+      }
+      if (count > 0) out[size++] = buffer & 0xFF;
+      header->size = size;
+      return 0;
+    }
+    case ENCODING_VARINT: {
+      size_t size = 0;
+      for (int i = 0; i < n; i++) {
+        uint32_t code = zigzag_encode(numbers[i]);
+        for (; code >= 0x80; code >>= 7) out[size++] = (code & 0x7F) | 0x80;
+        out[size++] = code;
+      }
+      header->size = size;
+      return 0;
+    }
+    default:
+      return -1;
+  }
+}
+
+int decoder_init(decoder_t* decoder, const payload_header_t* header,
+                 payload_reader_t reader, int fd) {
+  int64_t count = header->count;
+  int64_t size  = header->size;
+  if (count <= 0 || size < 0) return -1;
+  switch (header->encoding) {
+    case ENCODING_RAW:
+      if (size != count * (int64_t)sizeof(int)) return -1;
+      break;
+    case ENCODING_BITPACK:
+      if (header->bits < 0 || header->bits > 32 ||
+          size != (count * header->bits + 7) / 8)
+        return -1;
+      break;
+    case ENCODING_VARINT:
+      if (size < count || size > count * 5) return -1;
+      break;
+    default:
+      return -1;
+  }
+
+  decoder->header     = *header;
+  decoder->reader     = reader;
+  decoder->fd         = fd;
+  decoder->decoded    = 0;
+  decoder->remaining  = header->size;
+  decoder->input_size = 0;
+  decoder->position   = 0;
+  decoder->bit_buffer = 0;
+  decoder->bit_count  = 0;
+  return 0;
+}
+
+/**
+ * @brief Read the next piece of the payload into the input buffer
+ * 
+ * @param decoder The decoder
+ * @return int 0 on success, -1 if the payload is truncated or on error
+ */
+static int refill(decoder_t* decoder) {
+  size_t want = decoder->remaining < DECODER_BUFFER_SIZE
+                    ? (size_t)decoder->remaining
+                    : DECODER_BUFFER_SIZE;
+  if (want == 0) return -1;
+  if (decoder->reader(decoder->fd, decoder->input, want) != (ssize_t)want)
+    return -1;
+  decoder->remaining -= want;
+  decoder->input_size = want;
+  decoder->position   = 0;
+  return 0;
+}
+
+/**
+ * @brief Take the next payload byte, reading the next piece of the payload if needed
+ * 
+ * @param decoder The decoder
+ * @param byte The byte
+ * @return int 0 on success, -1 if the payload is truncated or on error
+ */
+static int next_byte(decoder_t* decoder, unsigned char* byte) {
+  if (decoder->position == decoder->input_size && refill(decoder) == -1)
+    return -1;
+  *byte = decoder->input[decoder->position++];
+  return 0;
+}
+
+int decoder_next(decoder_t* decoder, int* out, int max) {
+  const payload_header_t* header = &decoder->header;
+  int n = header->count - decoder->decoded;
+  if (n > max) n = max;
+
+  /**
+   * @brief Raw pieces always hold whole integers, so they are copied directly
+   * 
+   */
+  if (header->encoding == ENCODING_RAW) {
+    for (int i = 0; i < n;) {
+      if (decoder->position == decoder->input_size && refill(decoder) == -1)
+        return -1;
+      int available = (decoder->input_size - decoder->position) / sizeof(int);
+      if (available > n - i) available = n - i;
+      memcpy(out + i, decoder->input + decoder->position,
+             available * sizeof(int));
+      decoder->position += available * sizeof(int);
+      i += available;
+    }
+    decoder->decoded += n;
+    return n;
+  }
+
+  for (int i = 0; i < n; i++) {
+    unsigned char byte;
+    switch (header->encoding) {
+      case ENCODING_BITPACK:
+        while (decoder->bit_count < header->bits) {
+          if (next_byte(decoder, &byte) == -1) return -1;
+          decoder->bit_buffer |= (uint64_t)byte << decoder->bit_count;
+          decoder->bit_count += 8;
+        }
+        out[i] = (int)((uint32_t)header->base +
+                       (uint32_t)(decoder->bit_buffer &
+                                  (((uint64_t)1 << header->bits) - 1)));
+        decoder->bit_buffer >>= header->bits;
+        decoder->bit_count -= header->bits;
+        break;
+      case ENCODING_VARINT: {
+        uint32_t code  = 0;
+        int      shift = 0;
+        do {
+          if (shift > 28 || next_byte(decoder, &byte) == -1) return -1;
+          code |= (uint32_t)(byte & 0x7F) << shift;
+          shift += 7;
+        } while (byte & 0x80);
+        out[i] = zigzag_decode(code);
+        break;
+      }
+    }
+  }
+  decoder->decoded += n;
+  return n;
+}
+
+int decode_sum(decoder_t* decoder, int* sum, stream_stats_t* stats) {
+  int          chunk[DECODE_CHUNK_SIZE];
+  int          n;
+  unsigned int total = 0;
+  while ((n = decoder_next(decoder, chunk, DECODE_CHUNK_SIZE)) > 0) {
+    total += (unsigned int)sum_numbers(chunk, n);
+    if (stats != NULL) stream_stats_update(stats, chunk, n);
+  }
+  *sum = (int)total;
+  return n;
+}
+
+int decode_product(decoder_t* decoder, int* product) {
+  int          chunk[DECODE_CHUNK_SIZE];
+  int          n;
+  unsigned int total = 1;
+  while ((n = decoder_next(decoder, chunk, DECODE_CHUNK_SIZE)) > 0)
+    total *= (unsigned int)multiply_numbers(chunk, n);
+  *product = (int)total;
+  return n;
+}
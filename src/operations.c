@@ -0,0 +1,58 @@
+#include <bigint.h>
+#include <operations.h>
+#include <stdlib.h>
+#include <time.h>
+#include <write.h>
+
+void generate_random_numbers(int* numbers, int n) {
+  srand(time(NULL));
+  for (int i = 0; i < n; i++) numbers[i] = rand() % 10 + 1;
+}
+
+int sum_numbers(const int* numbers, int n) {
+  unsigned int sum = 0;
+  for (int i = 0; i < n; i++) sum += (unsigned int)numbers[i];
+  return (int)sum;
+}
+
+int multiply_numbers(const int* numbers, int n) {
+  unsigned int product = 1;
+  for (int i = 0; i < n; i++) product *= (unsigned int)numbers[i];
+  return (int)product;
+}
+
+int exact_result(const int* numbers, int n, int sum, int threads,
+                 char** product, char** total) {
+  bigint_t exact;
+  *product = NULL;
+  *total   = NULL;
+  if (bigint_product(&exact, numbers, n, threads) == -1) return -1;
+  *product = bigint_to_string(&exact);
+  if (*product == NULL) goto Error;
+  if (bigint_add_uint(&exact, (unsigned int)sum) == -1) goto Error;
+  *total = bigint_to_string(&exact);
+  if (*total == NULL) goto Error;
+  bigint_free(&exact);
+  return 0;
+
+Error:
+  free(*product);
+  *product = NULL;
+  bigint_free(&exact);
+  return -1;
+}
+
+int print_exact_result(const char* sender, const int* numbers, int n, int sum,
+                       int threads) {
+  char* product;
+  char* total;
+  if (exact_result(numbers, n, sum, threads, &product, &total) == -1)
+    return -1;
+  process_safe_write(1, "%s Exact result of multiplication: %s\n", sender,
+                     product);
+  process_safe_write(1, "%s Exact sum of the two results: %s\n", sender,
+                     total);
+  free(product);
+  free(total);
+  return 0;
+}
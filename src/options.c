@@ -0,0 +1,160 @@
+#include <affinity.h>
+#include <options.h>
+#include <process_jobs.h>
+#include <scheduler.h>
+#include <string.h>
+#include <write.h>
+
+int parse_options(int argc, char* argv[], options_t* options) {
+  options->numberOfRandomNumbers = DEFAULT_RANDOM_NUMBERS;
+  options->threads               = 0;
+  options->workers               = 0;
+  options->chunk_size            = DEFAULT_CHUNK_SIZE;
+  options->exact                 = 0;
+  options->huge_pages            = 0;
+  options->cpu_count             = 0;
+  options->io_uring              = 0;
+  options->encoding              = ENCODING_AUTO;
+  options->stats                 = 0;
+  options->retries               = 0;
+  options->deadline              = 0;
+  options->trace                 = NULL;
+  options->replay                = NULL;
+  options->replay_speed          = REPLAY_ORIGINAL;
+  options->pipeline              = NULL;
+  options->pipeline_file         = NULL;
+  options->fake_error            = 0;
+
+  int has_count    = 0;
+  int has_encoding = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--threads") == 0) {
+      options->threads = 1;
+    } else if (strcmp(argv[i], "--exact") == 0) {
+      options->exact = 1;
+    } else if (strcmp(argv[i], "--huge-pages") == 0) {
+      options->huge_pages = 1;
+    } else if (strcmp(argv[i], "--fake-error") == 0) {
+      options->fake_error = 1;
+    } else if (strcmp(argv[i], "--stats") == 0) {
+      options->stats = 1;
+    } else if (strcmp(argv[i], "--io-uring") == 0) {
+      options->io_uring = 1;
+    } else if (strcmp(argv[i], "--encoding") == 0 && i + 1 < argc) {
+      options->encoding = parse_encoding(argv[++i]);
+      has_encoding      = 1;
+      if (options->encoding == -1) return -1;
+    } else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "auto") == 0)
+        options->cpu_count = auto_cpu_list(options->cpus, MAX_PLACEMENT_CPUS);
+      else
+        options->cpu_count =
+            parse_cpu_list(argv[i], options->cpus, MAX_PLACEMENT_CPUS);
+      if (options->cpu_count < 1) return -1;
+    } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+      options->workers = str2uint(argv[++i]);
+      if (options->workers < 1 || options->workers > MAX_WORKERS) return -1;
+    } else if (strcmp(argv[i], "--retries") == 0 && i + 1 < argc) {
+      options->retries = str2uint(argv[++i]);
+      if (options->retries < 0) return -1;
+    } else if (strcmp(argv[i], "--deadline") == 0 && i + 1 < argc) {
+      options->deadline = str2uint(argv[++i]);
+      if (options->deadline < 1) return -1;
+    } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      options->trace = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      options->replay = argv[++i];
+    } else if (strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc) {
+      i++;
+      if (strcmp(argv[i], "original") == 0)
+        options->replay_speed = REPLAY_ORIGINAL;
+      else if (strcmp(argv[i], "max") == 0)
+        options->replay_speed = REPLAY_MAX;
+      else
+        return -1;
+    } else if (strcmp(argv[i], "--pipeline") == 0 && i + 1 < argc) {
+      options->pipeline = argv[++i];
+    } else if (strcmp(argv[i], "--pipeline-file") == 0 && i + 1 < argc) {
+      options->pipeline_file = argv[++i];
+    } else if (strcmp(argv[i], "--chunk-size") == 0 && i + 1 < argc) {
+      options->chunk_size = str2uint(argv[++i]);
+      if (options->chunk_size < 1) return -1;
+    } else if (!has_count && argv[i][0] != '-') {
+      options->numberOfRandomNumbers = str2uint(argv[i]);
+      has_count                      = 1;
+    } else {
+      return -1;
+    }
+  }
+  if (options->workers && (options->threads || options->exact)) return -1;
+  if (options->retries && !options->workers) return -1;
+  if (options->fake_error &&
+      (options->threads || options->workers || options->pipeline ||
+       options->pipeline_file))
+    return -1;
+  if (options->deadline && options->threads) return -1;
+  if ((options->trace || options->replay) &&
+      (options->threads || options->workers))
+    return -1;
+  if ((options->pipeline || options->pipeline_file) &&
+      (options->threads || options->workers || options->trace ||
+       options->replay || options->io_uring || options->exact ||
+       options->stats || options->huge_pages || has_encoding || has_count ||
+       (options->pipeline && options->pipeline_file)))
+    return -1;
+  return 0;
+}
+
+void print_usage(const char* name) {
+  /** @brief Two writes, the whole text does not fit in one log line buffer */
+  process_safe_write(2,
+                     "Usage: %s [options] "
+                     "[0 < number of random numbers <= %d]\n"
+                     "Default number of random numbers is %d\n"
+                     "  --threads         Run the jobs as threads of a single "
+                     "process\n"
+                     "  --workers N       Split the job over N <= %d "
+                     "work-stealing worker processes\n"
+                     "  --chunk-size K    Number of integers in a worker chunk "
+                     "task, default %d\n"
+                     "  --retries N       Respawn failed workers and requeue "
+                     "their chunks up to N times\n"
+                     "  --deadline MS     Cancel the job if it takes longer "
+                     "than MS milliseconds,\n"
+                     "                    not with --threads\n"
+                     "  --trace FILE      Record the fifo traffic to FILE, "
+                     "not with --threads or --workers\n"
+                     "  --replay FILE     Send the parent messages of a trace "
+                     "instead of a new job\n"
+                     "  --replay-speed S  Replay at the original speed "
+                     "(default) or at max speed\n",
+                     name, MAX_RANDOM_NUMBERS, DEFAULT_RANDOM_NUMBERS,
+                     MAX_WORKERS, DEFAULT_CHUNK_SIZE);
+  process_safe_write(2,
+                     "  --pipeline DESC   Run a stage graph such as "
+                     "\"gen:1000 -> map:square x2 -> filter:even\n"
+                     "                    -> reduce:sum\" instead of the "
+                     "two children\n"
+                     "  --pipeline-file F Read the stage graph description "
+                     "from F\n"
+                     "                    A stage graph only takes --deadline "
+                     "and --cpus\n"
+                     "  --exact           Also print the exact product, not "
+                     "with --workers\n"
+                     "  --huge-pages      Back large job buffers with huge "
+                     "pages\n"
+                     "  --cpus LIST|auto  Pin the parent, the first and the "
+                     "second child (or the workers)\n"
+                     "                    to the CPUs of LIST in order, or to "
+                     "cores sharing a cache\n"
+                     "  --io-uring        Batch the fifo traffic and the log "
+                     "with io_uring\n"
+                     "  --encoding NAME   Payload encoding: raw, bitpack, "
+                     "varint or auto (default)\n"
+                     "  --stats           Print mean, variance, quantiles and "
+                     "a histogram of the numbers\n"
+                     "  --fake-error      Make the parent fail after forking "
+                     "to exercise the\n"
+                     "                    error path of the two children\n");
+}
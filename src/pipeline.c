@@ -0,0 +1,496 @@
+#define _POSIX_C_SOURCE 1
+
+#include <affinity.h>
+#include <fcntl.h>
+#include <macros.h>
+#include <operations.h>
+#include <pipeline.h>
+#include <process_jobs.h>
+#include <safe_io.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <write.h>
+
+/**
+ * @brief Operator of a pipeline description
+ */
+typedef struct operator_entry_s {
+  const char*      text; /** Operator as written in the description */
+  stage_kind_t     kind; /** Kind of the stage */
+  stage_operator_t op;   /** Operator of the stage */
+} operator_entry_t;
+
+static const operator_entry_t operators[] = {
+    {"map:square", STAGE_MAP, OPERATOR_SQUARE},
+    {"map:double", STAGE_MAP, OPERATOR_DOUBLE},
+    {"map:negate", STAGE_MAP, OPERATOR_NEGATE},
+    {"map:increment", STAGE_MAP, OPERATOR_INCREMENT},
+    {"filter:even", STAGE_FILTER, OPERATOR_EVEN},
+    {"filter:odd", STAGE_FILTER, OPERATOR_ODD},
+    {"filter:positive", STAGE_FILTER, OPERATOR_POSITIVE},
+    {"reduce:sum", STAGE_REDUCE, OPERATOR_SUM},
+    {"reduce:product", STAGE_REDUCE, OPERATOR_PRODUCT},
+    {"reduce:min", STAGE_REDUCE, OPERATOR_MIN},
+    {"reduce:max", STAGE_REDUCE, OPERATOR_MAX},
+    {"reduce:count", STAGE_REDUCE, OPERATOR_COUNT},
+};
+
+static char description_file[MAX_PIPELINE_FILE + 1]; /** Description read from a file */
+
+/**
+ * @brief Parse a stage of a description
+ * 
+ * @param text The stage, without the surrounding arrows. It is modified.
+ * @param stage The stage to fill
+ * @return int 0 on success, -1 if the stage is invalid
+ */
+static int parse_stage(char* text, stage_t* stage) {
+  char* words[2];
+  int   count = 0;
+  for (char* word = strtok(text, " \t\r\n"); word != NULL;
+       word       = strtok(NULL, " \t\r\n")) {
+    if (count == 2) return -1;
+    words[count++] = word;
+  }
+  if (count == 0 || strlen(words[0]) >= STAGE_TEXT_SIZE) return -1;
+  strcpy(stage->text, words[0]);
+  stage->count       = 0;
+  stage->parallelism = 1;
+  if (count == 2) {
+    if (words[1][0] != 'x') return -1;
+    stage->parallelism = str2uint(words[1] + 1);
+    if (stage->parallelism < 1 || stage->parallelism > MAX_PIPELINE_INSTANCES)
+      return -1;
+  }
+
+  if (strncmp(words[0], "gen:", 4) == 0) {
+    stage->kind  = STAGE_GEN;
+    stage->op    = OPERATOR_GEN;
+    stage->count = str2uint(words[0] + 4);
+    return stage->count < 1 || stage->count > MAX_RANDOM_NUMBERS ? -1 : 0;
+  }
+  for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++) {
+    if (strcmp(words[0], operators[i].text) == 0) {
+      stage->kind = operators[i].kind;
+      stage->op   = operators[i].op;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+int pipeline_parse(const char* description, pipeline_t* pipeline) {
+  char text[MAX_PIPELINE_FILE + 1];
+  if (strlen(description) > MAX_PIPELINE_FILE) return -1;
+  strcpy(text, description);
+
+  pipeline->count = 0;
+  int   instances = 0;
+  char* stage     = text;
+  while (stage != NULL) {
+    char* arrow = strstr(stage, "->");
+    if (arrow != NULL) *arrow = '\0';
+    if (pipeline->count == MAX_STAGES ||
+        parse_stage(stage, &pipeline->stages[pipeline->count]) == -1)
+      return -1;
+    instances += pipeline->stages[pipeline->count++].parallelism;
+    stage = arrow == NULL ? NULL : arrow + 2;
+  }
+
+  /**
+   * @brief Numbers enter at the gen stage and leave at the reduce stage
+   * 
+   */
+  if (pipeline->count < 2 || instances > MAX_PIPELINE_INSTANCES) return -1;
+  for (int i = 0; i < pipeline->count; i++) {
+    stage_kind_t kind = pipeline->stages[i].kind;
+    if ((kind == STAGE_GEN) != (i == 0)) return -1;
+    if ((kind == STAGE_REDUCE) != (i == pipeline->count - 1)) return -1;
+  }
+  return 0;
+}
+
+/**
+ * @brief Apply a map or filter operator to a chunk in place
+ * 
+ * Arithmetic wraps around like the reductions of the operations module.
+ * 
+ * @param op The operator
+ * @param numbers The chunk
+ * @param n The number of integers in the chunk
+ * @return int The number of integers kept
+ */
+static int apply_operator(stage_operator_t op, int* numbers, int n) {
+  int kept = 0;
+  for (int i = 0; i < n; i++) {
+    unsigned int x = (unsigned int)numbers[i];
+    switch (op) {
+      case OPERATOR_SQUARE:
+        numbers[kept++] = (int)(x * x);
+        break;
+      case OPERATOR_DOUBLE:
+        numbers[kept++] = (int)(x * 2u);
+        break;
+      case OPERATOR_NEGATE:
+        numbers[kept++] = (int)(0u - x);
+        break;
+      case OPERATOR_INCREMENT:
+        numbers[kept++] = (int)(x + 1u);
+        break;
+      case OPERATOR_EVEN:
+        if (x % 2 == 0) numbers[kept++] = numbers[i];
+        break;
+      case OPERATOR_ODD:
+        if (x % 2 != 0) numbers[kept++] = numbers[i];
+        break;
+      case OPERATOR_POSITIVE:
+        if (numbers[i] > 0) numbers[kept++] = numbers[i];
+        break;
+      default:
+        numbers[kept++] = numbers[i];
+        break;
+    }
+  }
+  return kept;
+}
+
+/**
+ * @brief Merge a partial result into another
+ * 
+ * @param op The reduce operator
+ * @param result The partial result to merge into
+ * @param other The partial result to merge
+ */
+static void merge_results(stage_operator_t op, reduce_result_t* result,
+                          const reduce_result_t* other) {
+  if (other->count == 0) return;
+  if (result->count == 0) {
+    *result = *other;
+    return;
+  }
+  unsigned int a = (unsigned int)result->value;
+  unsigned int b = (unsigned int)other->value;
+  switch (op) {
+    case OPERATOR_PRODUCT:
+      result->value = (int)(a * b);
+      break;
+    case OPERATOR_MIN:
+      if (other->value < result->value) result->value = other->value;
+      break;
+    case OPERATOR_MAX:
+      if (other->value > result->value) result->value = other->value;
+      break;
+    default:
+      result->value = (int)(a + b);
+      break;
+  }
+  result->count += other->count;
+}
+
+/**
+ * @brief Reduce a chunk to a partial result
+ * 
+ * @param op The reduce operator
+ * @param numbers The chunk
+ * @param n The number of integers in the chunk, at least 1
+ * @return reduce_result_t The partial result
+ */
+static reduce_result_t reduce_chunk(stage_operator_t op, const int* numbers,
+                                    int n) {
+  reduce_result_t result = {numbers[0], n};
+  switch (op) {
+    case OPERATOR_SUM:
+      result.value = sum_numbers(numbers, n);
+      break;
+    case OPERATOR_PRODUCT:
+      result.value = multiply_numbers(numbers, n);
+      break;
+    case OPERATOR_MIN:
+      for (int i = 1; i < n; i++)
+        if (numbers[i] < result.value) result.value = numbers[i];
+      break;
+    case OPERATOR_MAX:
+      for (int i = 1; i < n; i++)
+        if (numbers[i] > result.value) result.value = numbers[i];
+      break;
+    default:
+      result.value = n;
+      break;
+  }
+  return result;
+}
+
+/**
+ * @brief Send a chunk message to the next instance of the next stage
+ * 
+ * A message is at most PIPE_BUF bytes, so the messages of several writers never interleave.
+ * 
+ * @param message The message, its first integer receives the count
+ * @param n The number of integers after the count
+ * @param outputs The pipes of the next stage
+ * @param output_count The number of pipes
+ * @param next The index of the next pipe, advanced round robin
+ * @return int 0 on success, -1 on error
+ */
+static int send_chunk(int* message, int n, const int* outputs,
+                      int output_count, int* next) {
+  if (n == 0) return 0;
+  message[0] = n;
+  int fd     = outputs[(*next)++ % output_count];
+  return write_all(fd, message, (n + 1) * sizeof(int)) == -1 ? -1 : 0;
+}
+
+/**
+ * @brief The job of a stage instance
+ * 
+ * A gen instance generates its share of the numbers. The other instances read chunk messages until
+ * every writer of their pipe closed it. A reduce instance sends its partial result to the parent.
+ * 
+ * @param pipeline The pipeline
+ * @param index The index of the stage
+ * @param instance The index of the instance in the stage
+ * @param input The pipe of the instance, -1 for a gen instance
+ * @param outputs The pipes of the next stage
+ * @param output_count The number of pipes of the next stage
+ * @param results The pipe of the partial results, -1 if the stage is not the reduce stage
+ * @return int 0 on success, -1 on error
+ */
+static int run_instance(const pipeline_t* pipeline, int index, int instance,
+                        int input, const int* outputs, int output_count,
+                        int results) {
+  const stage_t*  stage = &pipeline->stages[index];
+  int             message[PIPELINE_CHUNK_SIZE + 1];
+  int*            numbers  = message + 1;
+  int             received = 0;
+  int             sent     = 0;
+  int             next     = instance;
+  reduce_result_t result   = {0, 0};
+
+  if (stage->kind == STAGE_GEN) {
+    int share = stage->count / stage->parallelism +
+                (instance < stage->count % stage->parallelism);
+    srand((unsigned int)time(NULL) ^ ((unsigned int)getpid() << 16));
+    while (sent < share) {
+      int n = share - sent < PIPELINE_CHUNK_SIZE ? share - sent
+                                                 : PIPELINE_CHUNK_SIZE;
+      for (int i = 0; i < n; i++) numbers[i] = rand() % 10 + 1;
+      if (send_chunk(message, n, outputs, output_count, &next) == -1)
+        return -1;
+      sent += n;
+    }
+  } else {
+    ssize_t got;
+    while ((got = read_all(input, message, sizeof(int))) == sizeof(int)) {
+      int     n     = message[0];
+      ssize_t bytes = (ssize_t)(n * sizeof(int));
+      if (n < 1 || n > PIPELINE_CHUNK_SIZE ||
+          read_all(input, numbers, bytes) != bytes)
+        return -1;
+      received += n;
+      if (stage->kind == STAGE_REDUCE) {
+        reduce_result_t partial = reduce_chunk(stage->op, numbers, n);
+        merge_results(stage->op, &result, &partial);
+        continue;
+      }
+      n = apply_operator(stage->op, numbers, n);
+      if (send_chunk(message, n, outputs, output_count, &next) == -1)
+        return -1;
+      sent += n;
+    }
+    if (got != 0) return -1;
+  }
+
+  if (stage->kind == STAGE_REDUCE) {
+    if (write_all(results, &result, sizeof(result)) == -1) return -1;
+    sent = 1;
+  }
+  process_safe_write(1, "%s %d.%d %s received %d numbers and sent %d\n",
+                     STAGE_NAME, index, instance, stage->text, received, sent);
+  return 0;
+}
+
+/**
+ * @brief Read a pipeline description file
+ * 
+ * @param path The path of the file
+ * @return const char* The description, NULL on error
+ */
+static const char* read_description(const char* path) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) return NULL;
+  ssize_t size = read_all(fd, description_file, MAX_PIPELINE_FILE + 1);
+  close(fd);
+  if (size == -1 || size > MAX_PIPELINE_FILE) return NULL;
+  description_file[size] = '\0';
+  return description_file;
+}
+
+job_result_t pipeline_engine(const options_t* options) {
+  pipeline_t   pipeline;
+  int          first[MAX_STAGES + 1];
+  int          pipes[MAX_PIPELINE_INSTANCES][2];
+  int          results[2] = {-1, -1};
+  pid_t        pids[MAX_PIPELINE_INSTANCES];
+  int          started = 0;
+  int          total   = 0;
+  int          timer   = -1;
+  job_result_t status  = JOB_OK;
+  int cpu = place_self(options->cpus, options->cpu_count, 0, PARENT_NAME);
+  if (cpu == PLACEMENT_FAILED) return JOB_FAILED;
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", PARENT_NAME, cpu);
+
+  const char* description = options->pipeline;
+  if (options->pipeline_file != NULL)
+    description = read_description(options->pipeline_file);
+  ASSERT_GOTO(description != NULL, PARENT_NAME,
+              "Error reading pipeline file\n", Error_1);
+  ASSERT_GOTO(pipeline_parse(description, &pipeline) == 0, PARENT_NAME,
+              "Invalid pipeline\n", Error_1);
+  if (options->deadline > 0) {
+    timer = deadline_start(options->deadline);
+    ASSERT_GOTO(timer != -1, PARENT_NAME, "Error starting deadline\n",
+                Error_1);
+  }
+
+  /**
+   * @brief Create a pipe for every instance that reads chunks, and one for the partial results
+   * 
+   */
+  for (int i = 0; i < pipeline.count; i++) {
+    first[i] = total;
+    total += pipeline.stages[i].parallelism;
+  }
+  first[pipeline.count] = total;
+  for (int i = 0; i < total; i++) pipes[i][0] = pipes[i][1] = -1;
+  for (int i = first[1]; i < total; i++)
+    ASSERT_GOTO(pipe(pipes[i]) == 0, PARENT_NAME, "Error creating pipe\n",
+                Error_0);
+  ASSERT_GOTO(pipe(results) == 0, PARENT_NAME, "Error creating pipe\n",
+              Error_0);
+  process_safe_write(1, "%s Running %d stages in %d processes\n", PARENT_NAME,
+                     pipeline.count, total);
+
+  /**
+   * @brief Fork the instances
+   * Every instance keeps only the read end of its own pipe and the write ends of the next stage,
+   * so a stage sees end of file once every instance of the previous stage finished.
+   * 
+   */
+  for (int s = 0; s < pipeline.count; s++) {
+    int last = s == pipeline.count - 1;
+    for (int j = 0; j < pipeline.stages[s].parallelism; j++, started++) {
+      pids[started] = fork();
+      ASSERT_GOTO(pids[started] != -1, PARENT_NAME, "Error forking\n",
+                  Error_0);
+      if (pids[started] != 0) continue;
+
+      int outputs[MAX_PIPELINE_INSTANCES];
+      int output_count = 0;
+      for (int k = 0; k < total; k++) {
+        int is_output = !last && k >= first[s + 1] && k < first[s + 2];
+        if (pipes[k][0] != -1 && k != started) close(pipes[k][0]);
+        if (pipes[k][1] != -1 && !is_output) close(pipes[k][1]);
+        if (is_output) outputs[output_count++] = pipes[k][1];
+      }
+      close(results[0]);
+      if (!last) close(results[1]);
+      if (timer != -1) close(timer);
+      int cpu = place_self(options->cpus, options->cpu_count, started + 1,
+                           STAGE_NAME);
+      if (cpu == PLACEMENT_FAILED) exit(1);
+      if (cpu != -1)
+        process_safe_write(1, "%s %d.%d pinned to CPU %d\n", STAGE_NAME, s,
+                           j, cpu);
+      exit(run_instance(&pipeline, s, j, pipes[started][0], outputs,
+                        output_count, last ? results[1] : -1) == 0
+               ? 0
+               : 1);
+    }
+  }
+  for (int i = 0; i < total; i++) {
+    if (pipes[i][0] != -1) close(pipes[i][0]);
+    if (pipes[i][1] != -1) close(pipes[i][1]);
+    pipes[i][0] = pipes[i][1] = -1;
+  }
+  close(results[1]);
+  results[1] = -1;
+
+  /**
+   * @brief Merge the partial results of the reduce stage until every reduce instance finished
+   * 
+   */
+  const stage_t*  reduce = &pipeline.stages[pipeline.count - 1];
+  reduce_result_t result = {0, 0};
+  reduce_result_t partial;
+  while (1) {
+    int expired = deadline_wait(timer, results[0], -1);
+    ASSERT_GOTO(expired != -1, PARENT_NAME, "Error waiting for results\n",
+                Error_0);
+    if (expired) {
+      process_safe_write(1, "%s Job exceeded its deadline of %d ms\n",
+                         PARENT_NAME, options->deadline);
+      status = JOB_TIMEOUT;
+      break;
+    }
+    ssize_t got = read_all(results[0], &partial, sizeof(partial));
+    if (got == 0) break;
+    ASSERT_GOTO(got == sizeof(partial), PARENT_NAME,
+                "Error reading results\n", Error_0);
+    merge_results(reduce->op, &result, &partial);
+  }
+  if (status == JOB_TIMEOUT)
+    for (int i = 0; i < started; i++) kill(pids[i], SIGTERM);
+
+  /**
+   * @brief Wait for the instances
+   * 
+   */
+  for (int i = 0; i < started; i++) {
+    int instance_status;
+    ASSERT_GOTO(waitpid(pids[i], &instance_status, 0) == pids[i], PARENT_NAME,
+                "Error waiting for stage\n", Error_0);
+    if (status == JOB_OK &&
+        (!WIFEXITED(instance_status) || WEXITSTATUS(instance_status) != 0)) {
+      process_safe_write(2, "%s Process with PID %d failed\n", STAGE_NAME,
+                         pids[i]);
+      status = JOB_FAILED;
+    }
+  }
+  close(results[0]);
+  if (timer != -1) close(timer);
+
+  if (status == JOB_TIMEOUT)
+    process_safe_write(1, "%s Job timed out, late results are discarded\n",
+                       PARENT_NAME);
+  else if (status == JOB_OK && result.count == 0)
+    process_safe_write(1, "%s No numbers reached %s\n", PARENT_NAME,
+                       reduce->text);
+  else if (status == JOB_OK)
+    process_safe_write(1, "%s Result of %s: %d over %d numbers\n",
+                       PARENT_NAME, reduce->text, result.value, result.count);
+  process_safe_write(1, "%s Exiting\n", PARENT_NAME);
+  return status;
+
+  /**
+   * @brief Error handling
+   * 
+   */
+Error_0:
+  for (int i = 0; i < started; i++) kill(pids[i], SIGTERM);
+  for (int i = first[1]; i < total; i++) {
+    if (pipes[i][0] != -1) close(pipes[i][0]);
+    if (pipes[i][1] != -1) close(pipes[i][1]);
+  }
+  if (results[0] != -1) close(results[0]);
+  if (results[1] != -1) close(results[1]);
+  while (wait(NULL) > 0)
+    ;
+Error_1:
+  if (timer != -1) close(timer);
+  return JOB_FAILED;
+}
@@ -1,24 +1,50 @@
 #define _POSIX_C_SOURCE 1
 
+#include <affinity.h>
+#include <arena.h>
+#include <encoding.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <macros.h>
+#include <operations.h>
+#include <poll.h>
 #include <process_jobs.h>
+#include <safe_io.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/signalfd.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <sys/types.h>
 #include <sys/wait.h>
-#include <time.h>
+#include <trace.h>
 #include <unistd.h>
+#include <uring_io.h>
 #include <write.h>
 
-static int   fd1           = -1;   /** File descriptor for fifo1 */
-static int   fd2           = -1;   /** File descriptor for fifo2 */
-static int*  randomNumbers = NULL; /** Array of random numbers */
-static char* command = NULL;   /** Command to be passed to the second child */
-static int   child_number = 0; /** Number of the child process */
+#define OPEN_RETRY_MS 10 /** Delay between two opens of a fifo without reader */
+#define WAIT_LOG_MS 2000 /** Interval of the waiting log lines of the parent */
+#define LOG_FLUSH_MS 100 /** Age of the oldest queued log line that flushes the ring */
+
+static int     fd1           = -1;   /** File descriptor for fifo1 */
+static int     fd2           = -1;   /** File descriptor for fifo2 */
+static int*    randomNumbers = NULL; /** Array of random numbers */
+static char*   command       = NULL; /** Command to be passed to the second child */
+static int     child_number  = 0;    /** Number of the child process */
+static arena_t job_arena     = {0};  /** Arena of the buffers of the current job */
+static uring_t ring          = {0};  /** io_uring instance of the process */
+static int     use_uring     = 0;    /** 1 if the channels and the log go through the ring */
+static decoder_t decoder;            /** Decoder of the payload received by a child */
+static stream_stats_t stats;         /** Streaming statistics of the first child */
+static trace_t trace = {.fd = -1};   /** Recorder of the messages sent by the process */
+static int     results[2]    = {-1, -1}; /** Pipe carrying the second child's results to the parent */
+static int     timer         = -1;   /** Deadline timer of the parent, -1 without a deadline */
+static int     signals       = -1;   /** Signal file descriptor receiving SIGCHLD in the parent */
+static int     polled        = 0;    /** 1 if the parent writes the channels with writev_wait() */
+static int     expired       = 0;    /** 1 once the deadline of the parent expired */
+static int     submitting    = 0;    /** 1 while the parent waits on the ring */
+static uint64_t log_since    = 0;    /** Time of the oldest log line queued on the ring */
 
 /**
  * @brief Get the signal name object
@@ -49,14 +75,11 @@ static const char* get_signal_name(int signal) {
  * @return int  0 on success, -1 on error
  */
 int clear_all() {
-  if (randomNumbers != NULL) {
-    free(randomNumbers);
-    randomNumbers = NULL;
-  }
-  if (command != NULL) {
-    free(command);
-    command = NULL;
-  }
+  set_write_sink(NULL);
+  randomNumbers = NULL;
+  command       = NULL;
+  arena_destroy(&job_arena);
+  trace_close(&trace);
   if (fd1 != -1) {
     close(fd1);
     fd1 = -1;
@@ -65,9 +88,244 @@ int clear_all() {
     close(fd2);
     fd2 = -1;
   }
+  for (int i = 0; i < 2; i++) {
+    if (results[i] != -1) {
+      close(results[i]);
+      results[i] = -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Wait in the parent for the deadline, a child exit or a descriptor
+ * 
+ * The parent keeps SIGCHLD blocked and receives it through the signal file
+ * descriptor, so an exit can not slip in between a check of child_count and
+ * the wait. Exited children are reaped by calling sigchld_handler() here.
+ * Once the deadline expired the timer is no longer watched.
+ * 
+ * @param fd The other file descriptor to wait for, -1 for none
+ * @param events The poll events to wait for on fd
+ * @param timeout The timeout in milliseconds, -1 to wait without a timeout
+ * @param ready Set to 1 if fd is ready, may be NULL
+ * @return int 1 if the deadline expired during the wait, 0 otherwise, -1 on
+ * error
+ */
+static int wait_parent(int fd, short events, int timeout, int* ready) {
+  struct pollfd fds[3] = {
+      {expired ? -1 : timer, POLLIN, 0},
+      {signals, POLLIN, 0},
+      {fd, events, 0},
+  };
+  if (poll(fds, 3, timeout) == -1) return errno == EINTR ? 0 : -1;
+  if (fds[1].revents & POLLIN) {
+    struct signalfd_siginfo info;
+    while (read(signals, &info, sizeof(info)) > 0)
+      ;
+  }
+  sigchld_handler(SIGCHLD);
+  if (ready != NULL) *ready = fds[2].revents != 0;
+  if (!(fds[0].revents & POLLIN)) return 0;
+  expired = 1;
+  return 1;
+}
+
+/**
+ * @brief Wait until a channel or the ring of the parent is ready
+ * 
+ * @param fd The file descriptor of the channel
+ * @param events The poll events to wait for
+ * @return int 0 to retry the write, -1 if the deadline expired or on error
+ */
+static int wait_channel(int fd, short events) {
+  return wait_parent(fd, events, -1, NULL) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Submit everything queued on the ring
+ * 
+ * The children block in the kernel until the operations completed. The parent
+ * waits on the ring with wait_channel(), so the submission gives up and
+ * cancels the operations once the deadline expired. Log lines written while
+ * the parent waits, by the SIGCHLD handling, bypass the ring.
+ * 
+ * @return int 0 on success, -1 on error or if the deadline expired
+ */
+static int submit_ring() {
+  if (child_number != 0) return uring_submit_wait(&ring);
+  submitting = 1;
+  int status = uring_submit_poll(&ring, wait_channel);
+  submitting = 0;
+  return status;
+}
+
+/**
+ * @brief Log sink that queues the log lines on the ring
+ * 
+ * The lines are written with the next channel submission. The ring is
+ * submitted on its own only when the log buffer is full or the oldest queued
+ * line is older than LOG_FLUSH_MS, and when the process stops the ring.
+ * 
+ * @param fd The file descriptor of the log
+ * @param buf The log line
+ * @param count The length of the log line
+ * @return ssize_t count on success, -1 on error
+ */
+static ssize_t uring_log_sink(int fd, const void* buf, size_t count) {
+  if (submitting) return write_all(fd, buf, count);
+  uint64_t now = trace_now();
+  if (uring_queue_log(&ring, fd, buf, count) == -1) return -1;
+  if (ring.log_used == count) log_since = now;
+  if (ring.log_used > 0 && now - log_since >= LOG_FLUSH_MS * 1000000ull &&
+      submit_ring() == -1)
+    return -1;
+  return count;
+}
+
+/**
+ * @brief Stop using the ring
+ * 
+ * Queued log lines and channel writes are submitted before the ring is
+ * destroyed.
+ */
+static void stop_uring() {
+  if (!use_uring) return;
+  use_uring = 0;
+  set_write_sink(NULL);
+  uring_destroy(&ring);
+}
+
+/**
+ * @brief Send the channel traffic and the log through io_uring if requested
+ * 
+ * Falls back to the read and write path if io_uring is not available. The
+ * parent keeps SIGCHLD blocked for the whole job, so the handler can not log
+ * in the middle of a ring operation. Every role stops the ring itself before it
+ * returns, which writes the queued log lines. The exit and signal paths never
+ * touch it, the termination handler only switches the log back to plain
+ * writes.
+ * 
+ * @param options The options of the job
+ * @param name The name of the process
+ */
+static void start_uring(const options_t* options, const char* name) {
+  if (!options->io_uring) return;
+  if (uring_init(&ring) == -1) {
+    process_safe_write(1, "%s io_uring is not available, using read and write\n",
+                       name);
+    return;
+  }
+  use_uring = 1;
+  set_write_sink(uring_log_sink);
+}
+
+/**
+ * @brief Open the write end of a fifo in the parent
+ * 
+ * The open does not block, so it can not outlast the deadline or a child that
+ * died before it opened its end. Without a reader it fails with ENXIO and is
+ * retried every OPEN_RETRY_MS. The descriptor stays nonblocking unless the
+ * writes go through the ring, which waits for room itself.
+ * 
+ * @param path The path of the fifo
+ * @return int The file descriptor, -1 on error or if the deadline expired
+ */
+static int open_channel(const char* path) {
+  int fd;
+  while ((fd = open(path, O_WRONLY | O_NONBLOCK)) == -1 && errno == ENXIO)
+    if (wait_parent(-1, 0, OPEN_RETRY_MS, NULL) != 0) return -1;
+  if (fd != -1 && use_uring && set_nonblocking(fd, 0) == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/**
+ * @brief Register the open fifos and the standard outputs with the ring
+ * 
+ */
+static void register_channels() {
+  if (!use_uring) return;
+  int fds[4];
+  int count = 0;
+  if (fd1 != -1) fds[count++] = fd1;
+  if (fd2 != -1) fds[count++] = fd2;
+  fds[count++] = 1;
+  fds[count++] = 2;
+  uring_register_files(&ring, fds, count);
+}
+
+/**
+ * @brief Read from a channel
+ * 
+ * Any queued log line is submitted together with the read.
+ * 
+ * @param fd The file descriptor of the channel
+ * @param buf The buffer to read into
+ * @param count The number of bytes to read
+ * @return ssize_t The number of bytes read, less than count only at end of file, -1 on error
+ */
+static ssize_t channel_read(int fd, void* buf, size_t count) {
+  if (!use_uring) return read_all(fd, buf, count);
+  int op = uring_queue(&ring, 0, fd, buf, count);
+  if (op == -1 || submit_ring() == -1) return -1;
+  return uring_done(&ring, op);
+}
+
+/**
+ * @brief Write to a channel
+ * 
+ * With io_uring the buffers are only queued and must stay valid until
+ * channel_flush(). Without the ring the parent waits for room with
+ * wait_parent(), so a write gives up once the deadline expired. With --trace the message is recorded first. The records
+ * are buffered and only written when the buffer is full or the trace is
+ * closed, so the records of different processes are not in time order in the
+ * file. Every record carries its timestamp and its sender, and the records of
+ * one sender stay in order.
+ * 
+ * @param fd The file descriptor of the channel
+ * @param iov The buffers to write
+ * @param iovcnt The number of buffers
+ * @return int 0 on success, -1 on error
+ */
+static int channel_writev(int fd, struct iovec* iov, int iovcnt) {
+  int channel = fd == fd1 ? TRACE_CHANNEL_FIFO1 : TRACE_CHANNEL_FIFO2;
+  if (trace.fd != -1 &&
+      trace_record(&trace, channel, child_number, iov, iovcnt) == -1)
+    return -1;
+  if (polled) return writev_wait(fd, iov, iovcnt, wait_channel) == -1 ? -1 : 0;
+  if (!use_uring) return writev_all(fd, iov, iovcnt) == -1 ? -1 : 0;
+  for (int i = 0; i < iovcnt; i++)
+    if (uring_queue(&ring, 1, fd, iov[i].iov_base, iov[i].iov_len) == -1)
+      return -1;
   return 0;
 }
 
+/**
+ * @brief Submit the queued channel writes
+ * 
+ * The queued log lines go out in the same submission.
+ * 
+ * @return int 0 on success, -1 on error or if the deadline expired
+ */
+static int channel_flush() {
+  if (!use_uring) return 0;
+  return submit_ring();
+}
+
+/**
+ * @brief Release every buffer of the current job
+ * 
+ * The buffers live in the job arena, so a single reset releases all of them and the memory is reused by the next job.
+ */
+static void release_job() {
+  randomNumbers = NULL;
+  command       = NULL;
+  arena_reset(&job_arena);
+}
+
 /**
  * @brief Signal handler for SIGTERM, SIGINT, and SIGPIPE ...
  * 
@@ -101,10 +359,23 @@ static void term_handler(int signal) {
  * This function is called when the first child process is created.
  * It will read the random numbers from the fifo1, calculate the sum, and write it to fifo2.
  * 
+ * @param options The options of the job
  * @return int 0 on success, -1 on error
  */
-int first_child() {
+int first_child(const options_t* options) {
   child_number = 1;
+  int cpu = place_self(options->cpus, options->cpu_count, 1, FIRST_CHILD_NAME);
+  if (cpu == PLACEMENT_FAILED) return -1;
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", FIRST_CHILD_NAME, cpu);
+  close(results[0]);
+  close(results[1]);
+  results[0] = results[1] = -1;
+  arena_init(&job_arena, options->huge_pages);
+  start_uring(options, FIRST_CHILD_NAME);
+  if (options->trace != NULL &&
+      trace_open(&trace, options->trace, getppid(), 0) == -1)
+    process_safe_write(2, "%s Error opening trace\n", FIRST_CHILD_NAME);
 
   /**
    * @brief Signal handler for SIGTERM, SIGINT, and SIGPIPE ...
@@ -130,6 +401,7 @@ int first_child() {
 
   fd2 = open(fifo2, O_WRONLY);
   ASSERT_GOTO(fd2 != -1, FIRST_CHILD_NAME, "Error opening fifo2\n", Error_2);
+  register_channels();
 
   /**
    * @brief Sleep for 10 seconds
@@ -138,33 +410,34 @@ int first_child() {
   sleep(10);
 
   /**
-   * @brief Read the number of random numbers
+   * @brief Read the payload header
    * 
-   * @param numberOfRandomNumbers The number of random numbers
-   * @param randomNumbers The array of random numbers
+   * @param header The encoding and the number of random numbers
    */
-  int numberOfRandomNumbers;
-  ASSERT_GOTO(read(fd1, &numberOfRandomNumbers, sizeof(int)) != -1,
-              FIRST_CHILD_NAME, "Error reading number of random numbers\n",
-              Error_1);
-
-  randomNumbers = (int*)calloc(numberOfRandomNumbers, sizeof(int));
-  ASSERT_GOTO(randomNumbers != NULL, FIRST_CHILD_NAME,
-              "Error allocating memory\n", Error_1);
-  ASSERT_GOTO(
-      read(fd1, randomNumbers, numberOfRandomNumbers * sizeof(int)) != -1,
-      FIRST_CHILD_NAME, "Error reading random numbers\n", Error_0);
+  payload_header_t header;
+  ASSERT_GOTO(channel_read(fd1, &header, sizeof(header)) == sizeof(header),
+              FIRST_CHILD_NAME, "Error reading payload header\n", Error_1);
+  ASSERT_GOTO(header.count > 0 && header.count <= MAX_RANDOM_NUMBERS &&
+                  decoder_init(&decoder, &header, channel_read, fd1) == 0,
+              FIRST_CHILD_NAME, "Invalid payload header\n", Error_1);
+  if (use_uring)
+    uring_register_buffer(&ring, decoder.input, sizeof(decoder.input));
 
   /**
-   * @brief Calculate the sum of the random numbers
+   * @brief Decode the random numbers and calculate their sum in a single pass
    * 
    */
   int sum = 0;
-  for (int i = 0; i < numberOfRandomNumbers; i++) sum += randomNumbers[i];
-  free(randomNumbers);
-  randomNumbers = NULL;
-  ASSERT_GOTO(write(fd2, &sum, sizeof(int)) != -1, FIRST_CHILD_NAME,
-              "Error writing sum\n", Error_0);
+  if (options->stats)
+    stream_stats_init(&stats, HISTOGRAM_MIN, HISTOGRAM_MAX,
+                      HISTOGRAM_MAX - HISTOGRAM_MIN + 1);
+  ASSERT_GOTO(decode_sum(&decoder, &sum, options->stats ? &stats : NULL) == 0,
+              FIRST_CHILD_NAME, "Error reading random numbers\n", Error_0);
+  release_job();
+  struct iovec sum_iov = {&sum, sizeof(int)};
+  ASSERT_GOTO(channel_writev(fd2, &sum_iov, 1) == 0 && channel_flush() == 0,
+              FIRST_CHILD_NAME, "Error writing sum\n", Error_0);
+  trace_close(&trace);
 
   /**
    * @brief Close the file descriptors
@@ -177,7 +450,9 @@ int first_child() {
 
   process_safe_write(1, "%s Sum of random numbers: %d\n", FIRST_CHILD_NAME,
                      sum);
+  if (options->stats) stream_stats_print(FIRST_CHILD_NAME, &stats);
   process_safe_write(1, "%s Exiting\n", FIRST_CHILD_NAME);
+  stop_uring();
   return 0;
 
   /**
@@ -185,8 +460,7 @@ int first_child() {
    * 
    */
 Error_0:
-  free(randomNumbers);
-  randomNumbers = NULL;
+  release_job();
 Error_1:
   close(fd2);
   fd2 = -1;
@@ -194,6 +468,7 @@ Error_2:
   close(fd1);
   fd1 = -1;
 Error_3:
+  stop_uring();
   return -1;
 }
 
@@ -201,12 +476,23 @@ Error_3:
  * @brief The job of the second child process
  * 
  * This function is called when the second child process is created.
- * It will read the command, the random numbers, and the sum from the fifo2, calculate the result of the command, and write the sum of the two children * outputs to the stdout.
+ * It will read the command, the random numbers, and the sum from the fifo2, calculate the result of the command, and report it
+ * with the sum of the two children's outputs to the parent, which publishes them.
  * 
+ * @param options The options of the job
  * @return int 0 on success, -1 on error
  */
-int second_child() {
+int second_child(const options_t* options) {
   child_number = 2;
+  int cpu =
+      place_self(options->cpus, options->cpu_count, 2, SECOND_CHILD_NAME);
+  if (cpu == PLACEMENT_FAILED) return -1;
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", SECOND_CHILD_NAME, cpu);
+  close(results[0]);
+  results[0] = -1;
+  arena_init(&job_arena, options->huge_pages);
+  start_uring(options, SECOND_CHILD_NAME);
 
   /**
    * @brief Signal handler for SIGTERM, SIGINT, and SIGPIPE ...
@@ -229,6 +515,7 @@ int second_child() {
    */
   fd2 = open(fifo2, O_RDONLY);
   ASSERT_GOTO(fd2 != -1, SECOND_CHILD_NAME, "Error opening fifo2\n", Error_3);
+  register_channels();
 
   /**
    * @brief Read the command and the random numbers
@@ -239,76 +526,112 @@ int second_child() {
    * @param randomNumbers The array of random numbers
    */
   int commandLength = 0;
-  ASSERT_GOTO(read(fd2, &commandLength, sizeof(int)) != -1, SECOND_CHILD_NAME,
-              "Error reading command length\n", Error_2);
+  ASSERT_GOTO(channel_read(fd2, &commandLength, sizeof(int)) == sizeof(int),
+              SECOND_CHILD_NAME, "Error reading command length\n", Error_2);
   ASSERT_GOTO(commandLength > 0, SECOND_CHILD_NAME, "Invalid command length\n",
               Error_2);
 
-  command = (char*)calloc(commandLength + 1, sizeof(char));
+  command = (char*)arena_alloc(&job_arena, commandLength + 1);
   ASSERT_GOTO(command != NULL, SECOND_CHILD_NAME, "Error allocating memory\n",
               Error_2);
-  ASSERT_GOTO(read(fd2, command, commandLength) != -1, SECOND_CHILD_NAME,
-              "Error reading command\n", Error_1);
+  ASSERT_GOTO(channel_read(fd2, command, commandLength) == commandLength,
+              SECOND_CHILD_NAME, "Error reading command\n", Error_1);
   command[commandLength] = '\0';
 
-  int numberOfRandomNumbers;
-  ASSERT_GOTO(read(fd2, &numberOfRandomNumbers, sizeof(int)) != -1,
-              SECOND_CHILD_NAME, "Error reading number of random numbers\n",
-              Error_1);
-  randomNumbers = (int*)calloc(numberOfRandomNumbers, sizeof(int));
-  ASSERT_GOTO(randomNumbers != NULL, SECOND_CHILD_NAME,
-              "Error allocating memory\n", Error_1);
-  ASSERT_GOTO(
-      read(fd2, randomNumbers, numberOfRandomNumbers * sizeof(int)) != -1,
-      SECOND_CHILD_NAME, "Error reading random numbers\n", Error_0);
+  payload_header_t header;
+  ASSERT_GOTO(channel_read(fd2, &header, sizeof(header)) == sizeof(header),
+              SECOND_CHILD_NAME, "Error reading payload header\n", Error_1);
+  ASSERT_GOTO(header.count > 0 && header.count <= MAX_RANDOM_NUMBERS &&
+                  decoder_init(&decoder, &header, channel_read, fd2) == 0,
+              SECOND_CHILD_NAME, "Invalid payload header\n", Error_1);
+  if (use_uring)
+    uring_register_buffer(&ring, decoder.input, sizeof(decoder.input));
+  int numberOfRandomNumbers = header.count;
+
+  /**
+   * @brief Decode the random numbers
+   * The product is reduced while decoding, the array is only kept when the exact product needs it.
+   * 
+   */
+  int product = 0;
+  if (options->exact) {
+    randomNumbers = (int*)arena_alloc(&job_arena,
+                                      numberOfRandomNumbers * sizeof(int));
+    ASSERT_GOTO(randomNumbers != NULL, SECOND_CHILD_NAME,
+                "Error allocating memory\n", Error_1);
+    ASSERT_GOTO(decoder_next(&decoder, randomNumbers, numberOfRandomNumbers) ==
+                    numberOfRandomNumbers,
+                SECOND_CHILD_NAME, "Error reading random numbers\n", Error_0);
+    product = multiply_numbers(randomNumbers, numberOfRandomNumbers);
+  } else {
+    ASSERT_GOTO(decode_product(&decoder, &product) == 0, SECOND_CHILD_NAME,
+                "Error reading random numbers\n", Error_0);
+  }
 
   /**
    * @brief Try to read the sum from the fifo2
-   * If the fifo is empty read will return 0, so we need to try again. Until we get a value different from 0. Which is the sum of the first child or 
-   * -1 if there was an error.
+   * If the fifo has no writer read_all will stop at end of file, so we need to try again. Until the whole sum of the first child is received or 
+   * there is an error.
    * 
    */
-  int sum          = 0;
-  int return_value = -1;
+  int    sum      = 0;
+  size_t received = 0;
   do {
-    return_value = read(fd2, &sum, sizeof(int));
+    ssize_t return_value =
+        channel_read(fd2, (char*)&sum + received, sizeof(int) - received);
     ASSERT_GOTO(return_value != -1, SECOND_CHILD_NAME, "Error reading sum\n",
                 Error_0);
-  } while (return_value == 0);
+    received += return_value;
+  } while (received < sizeof(int));
   close(fd2);
   fd2 = -1;
   process_safe_write(1, "%s Received sum: %d\n", SECOND_CHILD_NAME, sum);
 
   /**
-   * @brief Calculate the result of the command
+   * @brief Calculate the result of the command and report it to the parent
+   * The parent publishes the results only if the job met its deadline.
    * 
    */
-  int result = 0;
+  job_report_t report        = {0};
+  char*        exact_product = NULL;
+  char*        exact_total   = NULL;
   if (strcmp(command, "multiply") == 0) {
-    result = 1;
-    for (int i = 0; i < numberOfRandomNumbers; i++) {
-      result *= randomNumbers[i];
+    report.product = product;
+    report.total   = product + sum;
+    if (options->exact) {
+      ASSERT_GOTO(exact_result(randomNumbers, numberOfRandomNumbers, sum, 1,
+                               &exact_product, &exact_total) == 0,
+                  SECOND_CHILD_NAME, "Error calculating exact result\n",
+                  Error_0);
+      report.exact_product = strlen(exact_product);
+      report.exact_total   = strlen(exact_total);
     }
-    process_safe_write(1, "%s Result of multiplication: %d\n",
-                       SECOND_CHILD_NAME, result);
-    process_safe_write(1, "%s Sum of two children's results: %d\n",
-                       SECOND_CHILD_NAME, result + sum);
   } else {
     process_safe_write(2, "%s Invalid command: %s\n", SECOND_CHILD_NAME,
                        command);
     goto Error_0;
   }
+  struct iovec report_iov[] = {
+      {&report, sizeof(report)},
+      {exact_product, report.exact_product},
+      {exact_total, report.exact_total},
+  };
+  ssize_t reported = writev_all(results[1], report_iov, 3);
+  free(exact_product);
+  free(exact_total);
+  ASSERT_GOTO(reported != -1, SECOND_CHILD_NAME, "Error reporting results\n",
+              Error_0);
+  close(results[1]);
+  results[1] = -1;
 
   /**
    * @brief Free the memory and exit
    * 
    */
-  free(command);
-  command = NULL;
-  free(randomNumbers);
-  randomNumbers = NULL;
+  release_job();
 
   process_safe_write(1, "%s Exiting\n", SECOND_CHILD_NAME);
+  stop_uring();
   return 0;
 
   /**
@@ -316,32 +639,216 @@ int second_child() {
    * 
    */
 Error_0:
-  free(randomNumbers);
-  randomNumbers = NULL;
 Error_1:
-  free(command);
-  command = NULL;
+  release_job();
 Error_2:
   close(fd2);
   fd2 = -1;
 Error_3:
+  stop_uring();
   return -1;
 }
 
+/**
+ * @brief Generate the random numbers and send them to the children
+ * 
+ * A failed write is reported by the caller, which tells a write that gave up
+ * at the deadline apart from an error.
+ * 
+ * @param options The options of the job
+ * @return int 0 on success, -1 on error
+ */
+static int send_job(const options_t* options) {
+  int numberOfRandomNumbers = options->numberOfRandomNumbers;
+
+  /**
+   * @brief Generate random numbers
+   * 
+   */
+  randomNumbers = (int*)arena_alloc(&job_arena,
+                                     numberOfRandomNumbers * sizeof(int));
+  ASSERT_GOTO(randomNumbers != NULL, PARENT_NAME, "Error allocating memory\n",
+              Error);
+  generate_random_numbers(randomNumbers, numberOfRandomNumbers);
+  process_safe_write(1, "%s Generated random numbers: %a\n", PARENT_NAME,
+                     randomNumbers, numberOfRandomNumbers);
+
+  /**
+   * @brief Encode the random numbers once for both children
+   * 
+   */
+  payload_header_t header;
+  unsigned char*   payload = (unsigned char*)arena_alloc(
+      &job_arena, encoded_size_bound(numberOfRandomNumbers));
+  ASSERT_GOTO(payload != NULL, PARENT_NAME, "Error allocating memory\n",
+              Error);
+  ASSERT_GOTO(encode_numbers(randomNumbers, numberOfRandomNumbers,
+                             options->encoding, &header, payload) == 0,
+              PARENT_NAME, "Error encoding random numbers\n", Error);
+  process_safe_write(1, "%s Encoded %d random numbers in %d bytes with %s\n",
+                     PARENT_NAME, numberOfRandomNumbers, header.size,
+                     encoding_name(header.encoding));
+  if (use_uring) uring_register_buffer(&ring, payload, header.size);
+
+  /**
+   * @brief Send the command and the random numbers to the second child
+   * The second child's data is written first. The first child writes its sum to fifo2 only after it read everything
+   * from fifo1, so the sum can not interleave with a payload bigger than the pipe buffer.
+   * 
+   */
+  command = arena_strdup(&job_arena, "multiply");
+  ASSERT_GOTO(command != NULL, PARENT_NAME, "Error allocating memory\n",
+              Error);
+  int          commandLength = strlen(command);
+  struct iovec second_iov[] = {
+      {&commandLength, sizeof(int)},
+      {command, commandLength},
+      {&header, sizeof(header)},
+      {payload, header.size},
+  };
+  if (channel_writev(fd2, second_iov, 4) == -1) goto Error;
+
+  /**
+   * @brief Send the random numbers to the first child
+   * 
+   */
+  struct iovec first_iov[] = {
+      {&header, sizeof(header)},
+      {payload, header.size},
+  };
+  if (channel_writev(fd1, first_iov, 2) == -1 || channel_flush() == -1)
+    goto Error;
+
+  return 0;
+
+Error:
+  return -1;
+}
+
+/**
+ * @brief Send the parent messages of a trace to the children
+ * 
+ * The messages of the children in the trace are skipped. At the original speed every message
+ * is sent with the delay it had from the first message when it was recorded. The pauses end
+ * early when the deadline expires. Every message is read into the job arena, which is reset
+ * once the previous message was flushed, so a replay reuses the same blocks.
+ * 
+ * @param options The options of the job
+ * @return int 0 on success, -1 on error
+ */
+static int replay_trace(const options_t* options) {
+  trace_record_t record;
+  int            replayed = 0;
+  int            status   = 0;
+  uint64_t       start    = trace_now();
+  uint64_t       first    = 0;
+  int            fd       = trace_reader_open(options->replay);
+  if (fd == -1) return -1;
+
+  while ((status = trace_read_record(fd, &record)) == 1) {
+    if (record.sender != 0) {
+      if (lseek(fd, record.size, SEEK_CUR) == -1) status = -1;
+      if (status == -1) break;
+      continue;
+    }
+    arena_reset(&job_arena);
+    void* message = arena_alloc(&job_arena, record.size);
+    if (message == NULL ||
+        read_all(fd, message, record.size) != (ssize_t)record.size) {
+      status = -1;
+      break;
+    }
+    if (replayed == 0) first = record.timestamp;
+    if (options->replay_speed == REPLAY_ORIGINAL) {
+      int paced = trace_pace(start, record.timestamp - first, timer);
+      if (paced == 1) expired = 1;
+      if (paced != 0) {
+        status = -1;
+        break;
+      }
+    }
+
+    struct iovec iov = {message, record.size};
+    int channel      = record.channel == TRACE_CHANNEL_FIFO1 ? fd1 : fd2;
+    if (channel_writev(channel, &iov, 1) == -1 || channel_flush() == -1) {
+      status = -1;
+      break;
+    }
+    replayed++;
+  }
+  close(fd);
+  if (status == -1 || replayed == 0) return -1;
+  process_safe_write(1, "%s Replayed %d messages from %s\n", PARENT_NAME,
+                     replayed, options->replay);
+  return 0;
+}
+
+/**
+ * @brief Read the results the second child reported
+ * 
+ * @param report The report to fill
+ * @param exact Receives the exact product and sum from the job arena, NULL
+ * without --exact
+ * @return int 0 on success, -1 on error
+ */
+static int read_report(job_report_t* report, char* exact[2]) {
+  if (read_all(results[0], report, sizeof(*report)) != sizeof(*report))
+    return -1;
+  int lengths[2] = {report->exact_product, report->exact_total};
+  for (int i = 0; i < 2; i++) {
+    if (lengths[i] <= 0) continue;
+    exact[i] = (char*)arena_alloc(&job_arena, lengths[i] + 1);
+    if (exact[i] == NULL ||
+        read_all(results[0], exact[i], lengths[i]) != lengths[i])
+      return -1;
+    exact[i][lengths[i]] = '\0';
+  }
+  return 0;
+}
+
 /**
  * @brief The job of the parent process
  * 
  * This function is called when the parent process is created.
  * It will generate random numbers, write them to fifo1, and send the command and the random numbers to the second child.
  * 
- * @param numberOfRandomNumbers The number of random numbers to generate
- * @return int 0 on success, -1 on error
+ * @param options The options of the job
+ * @return job_result_t JOB_OK on success, JOB_TIMEOUT if the deadline expired, JOB_FAILED on error
  */
-int parent(int numberOfRandomNumbers) {
+job_result_t parent(const options_t* options) {
   child_number = 0;
+  int cpu      = place_self(options->cpus, options->cpu_count, 0, PARENT_NAME);
+  if (cpu == PLACEMENT_FAILED) return JOB_FAILED;
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", PARENT_NAME, cpu);
+  arena_init(&job_arena, options->huge_pages);
+  close(results[1]);
+  results[1] = -1;
+
+  /**
+   * @brief Receive SIGCHLD through a file descriptor and start the deadline
+   * SIGCHLD stays blocked until the job is over, every wait of the parent
+   * goes through wait_parent().
+   * 
+   */
+  sigset_t child_signal;
+  sigemptyset(&child_signal);
+  sigaddset(&child_signal, SIGCHLD);
+  sigprocmask(SIG_BLOCK, &child_signal, NULL);
+  signals = signalfd(-1, &child_signal, SFD_CLOEXEC | SFD_NONBLOCK);
+  ASSERT_GOTO(signals != -1, PARENT_NAME, "Error creating signalfd\n",
+              Error_3);
+  if (options->deadline > 0) {
+    timer = deadline_start(options->deadline);
+    ASSERT_GOTO(timer != -1, PARENT_NAME, "Error starting deadline\n",
+                Error_3);
+  }
+  start_uring(options, PARENT_NAME);
+  polled = !use_uring;
 
   /**
    * @brief Signal handler for SIGCHLD
+   * It only runs on its own once SIGCHLD is unblocked again after the job.
    * 
    */
   struct sigaction sa = {0};
@@ -366,108 +873,153 @@ int parent(int numberOfRandomNumbers) {
   ASSERT_GOTO(sigaction(SIGPIPE, &sa2, NULL) != -1, PARENT_NAME,
               "Error setting signal handler\n", Error_3);
 
-  ASSERT_GOTO(0, PARENT_NAME, "Fake error\n", Error_3);
+  ASSERT_GOTO(!options->fake_error, PARENT_NAME, "Fake error\n", Error_3);
   /**
    * @brief Open the fifo1 and fifo2
+   * The opens and the writes below stop once the deadline expired.
    * 
    */
-  fd1 = open(fifo1, O_WRONLY);
-  ASSERT_GOTO(fd1 != -1, PARENT_NAME, "Error opening fifo1\n", Error_3);
-  fd2 = open(fifo2, O_WRONLY);
-  ASSERT_GOTO(fd2 != -1, PARENT_NAME, "Error opening fifo2\n", Error_2);
-
-  /**
-   * @brief Generate random numbers
-   * 
-   */
-  randomNumbers = (int*)calloc(numberOfRandomNumbers, sizeof(int));
-  ASSERT_GOTO(randomNumbers != NULL, PARENT_NAME, "Error allocating memory\n",
+  fd1 = open_channel(fifo1);
+  if (fd1 != -1) fd2 = open_channel(fifo2);
+  ASSERT_GOTO(fd2 != -1 || expired, PARENT_NAME, "Error opening fifos\n",
               Error_1);
-  srand(time(NULL));
-  for (int i = 0; i < numberOfRandomNumbers; i++)
-    randomNumbers[i] = rand() % 10 + 1;
-  process_safe_write(1, "%s Generated random numbers: %a\n", PARENT_NAME,
-                     randomNumbers, numberOfRandomNumbers);
-  ASSERT_GOTO(write(fd1, &numberOfRandomNumbers, sizeof(int)) != -1,
-              PARENT_NAME, "Error writing number of random numbers\n", Error_0);
-  ASSERT_GOTO(
-      write(fd1, randomNumbers, numberOfRandomNumbers * sizeof(int)) != -1,
-      PARENT_NAME, "Error writing random numbers\n", Error_0);
 
   /**
-   * @brief Send the command to the second child
+   * @brief Send the job, or the parent messages of a trace, to the children
    * 
    */
-  command = strdup_c("multiply");
-  ASSERT_GOTO(command != NULL, PARENT_NAME, "Error allocating memory\n",
-              Error_0);
-  int commandLength = strlen(command);
-  ASSERT_GOTO(write(fd2, &commandLength, sizeof(int)) != -1, PARENT_NAME,
-              "Error writing command length\n", Error_00);
-  ASSERT_GOTO(write(fd2, command, commandLength) != -1, PARENT_NAME,
-              "Error writing command\n", Error_00);
-  ASSERT_GOTO(write(fd2, &numberOfRandomNumbers, sizeof(int)) != -1,
-              PARENT_NAME, "Error writing number of random numbers\n",
-              Error_00);
-  ASSERT_GOTO(
-      write(fd2, randomNumbers, numberOfRandomNumbers * sizeof(int)) != -1,
-      PARENT_NAME, "Error writing random numbers\n", Error_00);
+  if (!expired) {
+    register_channels();
+    if (options->trace != NULL) {
+      ASSERT_GOTO(trace_open(&trace, options->trace, getpid(), 1) == 0,
+                  PARENT_NAME, "Error opening trace\n", Error_1);
+    }
+    int sent = options->replay != NULL ? replay_trace(options)
+                                       : send_job(options);
+    ASSERT_GOTO(sent == 0 || expired, PARENT_NAME,
+                options->replay != NULL ? "Error replaying trace\n"
+                                        : "Error sending job\n",
+                Error_0);
+  }
+  trace_close(&trace);
 
   /**
    * @brief Close the file descriptors and free the memory
    * 
    */
-  free(command);
-  command = NULL;
-  free(randomNumbers);
-  randomNumbers = NULL;
+  release_job();
+  stop_uring();
   close(fd1);
   fd1 = -1;
   close(fd2);
   fd2 = -1;
 
   /**
-   * @brief Wait for the children to finish
+   * @brief Wait for the children and the results, or for the deadline
+   * The deadline only cancels the job if a child or the results are still
+   * missing once it expired. Then the job is marked cancelled, so the exits of
+   * the terminated children are not treated as failures, and the results are
+   * discarded.
    * 
    */
-  int seconds = 0;
-  while (child_count > 0) {
-    process_safe_write(1,
-                       "%s Waiting for children to finish, "
-                       "waited %d seconds, %d "
-                       "children remaining\n",
-                       PARENT_NAME, seconds, child_count);
-    sleep(2);
-    seconds += 2;
+  job_report_t report   = {0};
+  char*        exact[2] = {NULL, NULL};
+  int          reported = 0;
+  int          seconds  = 0;
+  uint64_t     next_log = trace_now();
+  while (!expired && (child_count > 0 || !reported)) {
+    uint64_t now = trace_now();
+    if (now >= next_log) {
+      process_safe_write(1,
+                         "%s Waiting for children to finish, "
+                         "waited %d seconds, %d "
+                         "children remaining\n",
+                         PARENT_NAME, seconds, child_count);
+      seconds += WAIT_LOG_MS / 1000;
+      next_log += WAIT_LOG_MS * 1000000ull;
+      continue;
+    }
+    int ready   = 0;
+    int timeout = (int)((next_log - now) / 1000000u) + 1;
+    ASSERT_GOTO(wait_parent(reported ? -1 : results[0], POLLIN, timeout,
+                            &ready) != -1,
+                PARENT_NAME, "Error waiting for children\n", Error_3);
+    if (ready && !reported) {
+      ASSERT_GOTO(read_report(&report, exact) == 0, PARENT_NAME,
+                  "Error reading results\n", Error_3);
+      reported = 1;
+    }
   }
-  process_safe_write(1, "%s Exiting\n", PARENT_NAME);
 
-  return 0;
+  job_result_t result = JOB_OK;
+  if (expired && (child_count > 0 || !reported)) {
+    job_cancelled = 1;
+    process_safe_write(1, "%s Job exceeded its deadline of %d ms\n",
+                       PARENT_NAME, options->deadline);
+    kill_children();
+    while (child_count > 0)
+      ASSERT_GOTO(wait_parent(-1, 0, -1, NULL) != -1, PARENT_NAME,
+                  "Error waiting for children\n", Error_3);
+    result = JOB_TIMEOUT;
+  }
+  if (timer != -1) close(timer);
+  timer = -1;
+  close(signals);
+  signals = -1;
+  sigprocmask(SIG_UNBLOCK, &child_signal, NULL);
+  close(results[0]);
+  results[0] = -1;
+
+  /**
+   * @brief Publish the results of the second child
+   * 
+   */
+  if (result == JOB_TIMEOUT) {
+    process_safe_write(1, "%s Job timed out, late results are discarded\n",
+                       PARENT_NAME);
+  } else {
+    process_safe_write(1, "%s Result of multiplication: %d\n", PARENT_NAME,
+                       report.product);
+    process_safe_write(1, "%s Sum of two children's results: %d\n",
+                       PARENT_NAME, report.total);
+    if (exact[0] != NULL) {
+      process_safe_write(1, "%s Exact result of multiplication: %s\n",
+                         PARENT_NAME, exact[0]);
+      process_safe_write(1, "%s Exact sum of the two results: %s\n",
+                         PARENT_NAME, exact[1]);
+    }
+  }
+  release_job();
+  process_safe_write(1, "%s Exiting\n", PARENT_NAME);
+  return result;
 
   /**
    * @brief Error handling
    * 
    */
-Error_00:
-  free(command);
-  command = NULL;
 Error_0:
-  free(randomNumbers);
-  randomNumbers = NULL;
+  release_job();
 Error_1:
   close(fd2);
   fd2 = -1;
-Error_2:
   close(fd1);
   fd1 = -1;
 Error_3:
-  return -1;
+  stop_uring();
+  trace_close(&trace);
+  if (timer != -1) close(timer);
+  timer = -1;
+  if (signals != -1) close(signals);
+  signals = -1;
+  sigprocmask(SIG_UNBLOCK, &child_signal, NULL);
+  return JOB_FAILED;
 }
 
 /**
  * @brief Open the fifos
  * 
- * This function will open the fifos fifo1 and fifo2.
+ * This function will open the fifos fifo1 and fifo2, and the pipe that
+ * carries the results of the second child to the parent.
  * 
  * @return int 0 on success, -1 on error
  */
@@ -488,6 +1040,12 @@ int open_fifos() {
       return -1;
     }
   }
+
+  if (pipe(results) == -1) {
+    process_safe_write(2, "%s Error creating results pipe\n", PARENT_NAME);
+    unlink_fifos();
+    return -1;
+  }
   return 0;
 }
 
@@ -0,0 +1,132 @@
+#define _POSIX_C_SOURCE 1
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <safe_io.h>
+#include <unistd.h>
+
+/**
+ * @brief Wait with poll() until a file descriptor is ready
+ * 
+ * @param fd The file descriptor
+ * @param events The poll events to wait for
+ * @return int 0 once the file descriptor is ready, -1 on error
+ */
+static int wait_ready(int fd, short events) {
+  struct pollfd pfd = {0};
+  pfd.fd            = fd;
+  pfd.events        = events;
+  while (poll(&pfd, 1, -1) == -1)
+    if (errno != EINTR) return -1;
+  return 0;
+}
+
+/**
+ * @brief Decide what to do after a failed transfer call
+ * 
+ * Interrupted calls are retried immediately, calls on a nonblocking file descriptor
+ * wait until the file descriptor is ready.
+ * 
+ * @param fd The file descriptor
+ * @param events The poll events to wait for
+ * @param wait The function that waits until the file descriptor is ready
+ * @return int 0 if the call should be retried, -1 on error
+ */
+static int wait_retry(int fd, short events, io_wait_t wait) {
+  if (errno == EINTR) return 0;
+  if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+  return wait(fd, events);
+}
+
+/**
+ * @brief Skip the bytes already transferred in an iovec array
+ * 
+ * @param iov The iovec array
+ * @param iovcnt The number of buffers in the array
+ * @param done The number of bytes transferred
+ * @return int The number of consumed buffers
+ */
+static int advance_iov(struct iovec* iov, int iovcnt, size_t done) {
+  int consumed = 0;
+  while (consumed < iovcnt && done >= iov[consumed].iov_len) {
+    done -= iov[consumed].iov_len;
+    consumed++;
+  }
+  if (consumed < iovcnt) {
+    iov[consumed].iov_base = (char*)iov[consumed].iov_base + done;
+    iov[consumed].iov_len -= done;
+  }
+  return consumed;
+}
+
+ssize_t read_all(int fd, void* buf, size_t count) {
+  size_t done = 0;
+  while (done < count) {
+    ssize_t n = read(fd, (char*)buf + done, count - done);
+    if (n == 0) break;
+    if (n == -1) {
+      if (wait_retry(fd, POLLIN, wait_ready) == -1) return -1;
+      continue;
+    }
+    done += n;
+  }
+  return done;
+}
+
+ssize_t write_all(int fd, const void* buf, size_t count) {
+  size_t done = 0;
+  while (done < count) {
+    ssize_t n = write(fd, (const char*)buf + done, count - done);
+    if (n == -1) {
+      if (wait_retry(fd, POLLOUT, wait_ready) == -1) return -1;
+      continue;
+    }
+    done += n;
+  }
+  return done;
+}
+
+ssize_t readv_all(int fd, struct iovec* iov, int iovcnt) {
+  size_t done = 0;
+  while (iovcnt > 0) {
+    ssize_t n = readv(fd, iov, iovcnt);
+    if (n == 0) break;
+    if (n == -1) {
+      if (wait_retry(fd, POLLIN, wait_ready) == -1) return -1;
+      continue;
+    }
+    done += n;
+    int consumed = advance_iov(iov, iovcnt, n);
+    iov += consumed;
+    iovcnt -= consumed;
+  }
+  return done;
+}
+
+ssize_t writev_all(int fd, struct iovec* iov, int iovcnt) {
+  return writev_wait(fd, iov, iovcnt, wait_ready);
+}
+
+ssize_t writev_wait(int fd, struct iovec* iov, int iovcnt, io_wait_t wait) {
+  size_t done = 0;
+  while (iovcnt > 0) {
+    ssize_t n = writev(fd, iov, iovcnt);
+    if (n == -1) {
+      if (wait_retry(fd, POLLOUT, wait) == -1) return -1;
+      continue;
+    }
+    done += n;
+    int consumed = advance_iov(iov, iovcnt, n);
+    iov += consumed;
+    iovcnt -= consumed;
+  }
+  return done;
+}
+
+int set_nonblocking(int fd, int enable) {
+  int flags = fcntl(fd, F_GETFL);
+  if (flags == -1) return -1;
+  flags = enable ? flags | O_NONBLOCK : flags & ~O_NONBLOCK;
+  return fcntl(fd, F_SETFL, flags);
+}
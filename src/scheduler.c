@@ -0,0 +1,555 @@
+#define _GNU_SOURCE
+
+#include <affinity.h>
+#include <macros.h>
+#include <operations.h>
+#include <process_jobs.h>
+#include <scheduler.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <write.h>
+
+/**
+ * @brief Lock a deque, recovering the lock of a worker that died holding it
+ * 
+ * Every update of a deque leaves it consistent before the next one starts, so the
+ * state protected by an abandoned lock is usable as is.
+ * 
+ * @param deque The deque
+ */
+static void deque_lock(worker_deque_t* deque) {
+  if (pthread_mutex_lock(&deque->lock) == EOWNERDEAD)
+    pthread_mutex_consistent(&deque->lock);
+}
+
+/**
+ * @brief Push a task to the bottom of a deque
+ * 
+ * @param deque The deque
+ * @param task The index of the chunk task
+ * @param capacity The capacity of the ring
+ */
+static void deque_push(worker_deque_t* deque, int task, int capacity) {
+  deque_lock(deque);
+  deque->tasks[deque->bottom % capacity] = task;
+  deque->bottom++;
+  pthread_mutex_unlock(&deque->lock);
+}
+
+/**
+ * @brief Pop a task from the bottom of a deque, used by the owner
+ * 
+ * The task is claimed for the worker before it leaves the deque, so a worker that dies
+ * at any point leaves its task either in the deque or claimed by itself.
+ * 
+ * @param deque The deque
+ * @param capacity The capacity of the ring
+ * @param states The states of the chunk tasks
+ * @param worker The index of the claiming worker
+ * @return int The index of the chunk task, -1 if the deque is empty
+ */
+static int deque_pop(worker_deque_t* deque, int capacity, int* states,
+                     int worker) {
+  int task = -1;
+  deque_lock(deque);
+  if (deque->top < deque->bottom) {
+    task = deque->tasks[(deque->bottom - 1) % capacity];
+    __atomic_store_n(&states[task], worker, __ATOMIC_RELEASE);
+    deque->bottom--;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return task;
+}
+
+/**
+ * @brief Steal a task from the top of a deque, used by the other workers
+ * 
+ * @param deque The deque
+ * @param capacity The capacity of the ring
+ * @param states The states of the chunk tasks
+ * @param worker The index of the claiming worker
+ * @return int The index of the chunk task, -1 if the deque is empty
+ */
+static int deque_steal(worker_deque_t* deque, int capacity, int* states,
+                       int worker) {
+  int task = -1;
+  deque_lock(deque);
+  if (deque->top < deque->bottom) {
+    task = deque->tasks[deque->top % capacity];
+    __atomic_store_n(&states[task], worker, __ATOMIC_RELEASE);
+    deque->top++;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return task;
+}
+
+/**
+ * @brief Destroy the scheduler and unmap the shared memory region
+ * 
+ * @param scheduler The scheduler
+ */
+static void scheduler_destroy(scheduler_t* scheduler) {
+  if (scheduler->region == NULL) return;
+  for (int i = 0; i < scheduler->worker_count; i++)
+    pthread_mutex_destroy(&scheduler->deques[i].lock);
+  munmap(scheduler->region, scheduler->region_size);
+  scheduler->region = NULL;
+}
+
+/**
+ * @brief Map the shared memory region, generate the job and spread its chunk tasks over the deques
+ * 
+ * Every worker starts with a contiguous block of chunks, the rest is balanced by stealing.
+ * 
+ * @param scheduler The scheduler
+ * @param count The number of random numbers
+ * @param workers The number of worker processes
+ * @param chunk_size The number of integers in a chunk task
+ * @param stats 1 to give every worker a partial statistics state
+ * @return int 0 on success, -1 on error
+ */
+static int scheduler_init(scheduler_t* scheduler, int count, int workers,
+                          int chunk_size, int stats) {
+  if (chunk_size > count) chunk_size = count;
+  scheduler->count        = count;
+  scheduler->chunk_size   = chunk_size;
+  scheduler->chunk_count  = (count + chunk_size - 1) / chunk_size;
+  scheduler->worker_count = 0;
+
+  int    chunks        = scheduler->chunk_count;
+  size_t deques_size   = workers * sizeof(worker_deque_t);
+  size_t tasks_size    = (size_t)workers * chunks * sizeof(int);
+  size_t results_size  = chunks * sizeof(chunk_result_t);
+  size_t stats_size    = stats ? workers * sizeof(stream_stats_t) : 0;
+  size_t states_size   = chunks * sizeof(int) + sizeof(int);
+  size_t numbers_size  = count * sizeof(int);
+  scheduler->region_size = deques_size + tasks_size + results_size +
+                           stats_size + states_size + numbers_size;
+  scheduler->region = mmap(NULL, scheduler->region_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (scheduler->region == MAP_FAILED) {
+    scheduler->region = NULL;
+    return -1;
+  }
+
+  char* cursor       = (char*)scheduler->region;
+  scheduler->deques  = (worker_deque_t*)cursor;
+  cursor            += deques_size;
+  int* tasks         = (int*)cursor;
+  cursor            += tasks_size;
+  scheduler->results = (chunk_result_t*)cursor;
+  cursor            += results_size;
+  scheduler->stats   = stats ? (stream_stats_t*)cursor : NULL;
+  cursor            += stats_size;
+  scheduler->chunk_states = (int*)cursor;
+  scheduler->cancelled    = scheduler->chunk_states + chunks;
+  cursor                 += states_size;
+  scheduler->numbers      = (int*)cursor;
+
+  pthread_mutexattr_t attr;
+  if (pthread_mutexattr_init(&attr) != 0) goto Error;
+  pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+  pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+  for (int i = 0; i < workers; i++) {
+    worker_deque_t* deque = &scheduler->deques[i];
+    if (pthread_mutex_init(&deque->lock, &attr) != 0) {
+      pthread_mutexattr_destroy(&attr);
+      goto Error;
+    }
+    scheduler->worker_count++;
+    deque->tasks = tasks + (size_t)i * chunks;
+  }
+  pthread_mutexattr_destroy(&attr);
+  for (int i = 0; stats && i < workers; i++)
+    stream_stats_init(&scheduler->stats[i], HISTOGRAM_MIN, HISTOGRAM_MAX,
+                      HISTOGRAM_MAX - HISTOGRAM_MIN + 1);
+
+  for (int i = 0; i < chunks; i++) {
+    scheduler->chunk_states[i] = CHUNK_PENDING;
+    deque_push(&scheduler->deques[(long)i * workers / chunks], i, chunks);
+  }
+
+  generate_random_numbers(scheduler->numbers, count);
+  return 0;
+
+Error:
+  scheduler_destroy(scheduler);
+  return -1;
+}
+
+/**
+ * @brief Run a chunk task with the operations of the first and second child
+ * 
+ * The chunk also updates the partial statistics of the worker that runs it.
+ * 
+ * @param scheduler The scheduler
+ * @param worker The index of the worker
+ * @param task The index of the chunk task
+ */
+static void run_task(scheduler_t* scheduler, int worker, int task) {
+  int begin = task * scheduler->chunk_size;
+  int end   = begin + scheduler->chunk_size;
+  if (end > scheduler->count) end = scheduler->count;
+
+  scheduler->results[task].sum =
+      sum_numbers(scheduler->numbers + begin, end - begin);
+  scheduler->results[task].product =
+      multiply_numbers(scheduler->numbers + begin, end - begin);
+  if (scheduler->stats != NULL)
+    stream_stats_update(&scheduler->stats[worker], scheduler->numbers + begin,
+                        end - begin);
+}
+
+/**
+ * @brief The job of a worker process
+ * 
+ * It will run the tasks of its own deque and then steal from the others until every deque is empty
+ * or the job is cancelled.
+ * 
+ * @param scheduler The scheduler
+ * @param worker The index of the worker
+ * @return int 0 on success
+ */
+static int worker_loop(scheduler_t* scheduler, int worker) {
+  worker_deque_t* own    = &scheduler->deques[worker];
+  int             chunks = scheduler->chunk_count;
+  int*            states = scheduler->chunk_states;
+  while (!__atomic_load_n(scheduler->cancelled, __ATOMIC_ACQUIRE)) {
+    int task = deque_pop(own, chunks, states, worker);
+    for (int i = 1; task == -1 && i < scheduler->worker_count; i++) {
+      int victim = (worker + i) % scheduler->worker_count;
+      task = deque_steal(&scheduler->deques[victim], chunks, states, worker);
+      if (task != -1) own->stolen++;
+    }
+    if (task == -1) break;
+    run_task(scheduler, worker, task);
+    __atomic_store_n(&states[task], CHUNK_DONE(worker), __ATOMIC_RELEASE);
+    own->executed++;
+  }
+  return 0;
+}
+
+/**
+ * @brief Fork a worker process
+ * 
+ * @param scheduler The scheduler
+ * @param options The options of the job
+ * @param worker The index of the worker
+ * @return pid_t The PID of the worker, -1 on error
+ */
+static pid_t spawn_worker(scheduler_t* scheduler, const options_t* options,
+                          int worker) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    int cpu =
+        place_self(options->cpus, options->cpu_count, worker + 1, WORKER_NAME);
+    if (cpu == PLACEMENT_FAILED) exit(1);
+    if (cpu != -1)
+      process_safe_write(1, "%s %d pinned to CPU %d\n", WORKER_NAME, worker,
+                         cpu);
+    exit(worker_loop(scheduler, worker));
+  }
+  return pid;
+}
+
+/**
+ * @brief Requeue the chunk tasks a dead worker had not acknowledged
+ * 
+ * A chunk claimed by the worker is requeued unless it is still in a deque, which happens
+ * when the worker died between claiming it and taking it out. With statistics the partial
+ * state of the worker is lost, so the chunks it acknowledged are requeued as well.
+ * 
+ * @param scheduler The scheduler
+ * @param worker The index of the dead worker
+ * @return int The number of requeued chunk tasks, -1 on error
+ */
+static int requeue_chunks(scheduler_t* scheduler, int worker) {
+  int   chunks = scheduler->chunk_count;
+  char* queued = calloc(chunks, 1);
+  if (queued == NULL) return -1;
+
+  /** @brief Only the parent moves tasks into a deque, so a chunk seen outside stays outside */
+  for (int i = 0; i < scheduler->worker_count; i++) {
+    worker_deque_t* deque = &scheduler->deques[i];
+    deque_lock(deque);
+    for (int j = deque->top; j < deque->bottom; j++)
+      queued[deque->tasks[j % chunks]] = 1;
+    pthread_mutex_unlock(&deque->lock);
+  }
+  if (scheduler->stats != NULL)
+    stream_stats_init(&scheduler->stats[worker], HISTOGRAM_MIN, HISTOGRAM_MAX,
+                      HISTOGRAM_MAX - HISTOGRAM_MIN + 1);
+
+  int requeued = 0;
+  for (int i = 0; i < chunks; i++) {
+    int state = __atomic_load_n(&scheduler->chunk_states[i], __ATOMIC_ACQUIRE);
+    int lost  = state == worker ||
+               (scheduler->stats != NULL && state == CHUNK_DONE(worker));
+    if (!lost || queued[i]) continue;
+    scheduler->chunk_states[i] = CHUNK_PENDING;
+    deque_push(&scheduler->deques[worker], i, chunks);
+    requeued++;
+  }
+  free(queued);
+  return requeued;
+}
+
+/**
+ * @brief Kill the workers that are still running
+ * 
+ * @param pids The process ids of the workers
+ * @param alive 1 for every worker that is still running
+ * @param workers The number of workers
+ */
+static void kill_workers(const pid_t* pids, const int* alive, int workers) {
+  for (int i = 0; i < workers; i++)
+    if (alive[i]) kill(pids[i], SIGKILL);
+}
+
+/**
+ * @brief Cancel the job once its deadline expired
+ * 
+ * The workers stop at their next chunk boundary. The returned timer expires
+ * after CANCEL_GRACE_MS, then the workers that are still running are killed.
+ * If the grace timer can not be started they are killed right away.
+ * 
+ * @param scheduler The scheduler
+ * @param options The options of the job
+ * @param timer The expired deadline timer, it is closed
+ * @param pids The process ids of the workers
+ * @param alive 1 for every worker that is still running
+ * @return int The grace timer, -1 if the workers were killed
+ */
+static int cancel_job(scheduler_t* scheduler, const options_t* options,
+                      int timer, const pid_t* pids, const int* alive) {
+  __atomic_store_n(scheduler->cancelled, 1, __ATOMIC_RELEASE);
+  process_safe_write(1, "%s Job exceeded its deadline of %d ms\n",
+                     PARENT_NAME, options->deadline);
+  close(timer);
+  int grace = deadline_start(CANCEL_GRACE_MS);
+  if (grace == -1) {
+    process_safe_write(2, "%s Error starting grace period, killing workers\n",
+                       PARENT_NAME);
+    kill_workers(pids, alive, options->workers);
+  }
+  return grace;
+}
+
+/**
+ * @brief The scheduler engine
+ * 
+ * It will generate random numbers in shared memory, fork the worker processes, wait for them and merge
+ * the partial results in chunk order, so the result does not depend on which worker ran which chunk.
+ * 
+ * @param options The options of the job
+ * @return job_result_t JOB_OK on success, JOB_TIMEOUT if the deadline expired, JOB_FAILED on error
+ */
+job_result_t scheduler_engine(const options_t* options) {
+  int         numberOfRandomNumbers = options->numberOfRandomNumbers;
+  int         workers               = options->workers;
+  scheduler_t scheduler             = {0};
+  int         cpu =
+      place_self(options->cpus, options->cpu_count, 0, PARENT_NAME);
+  if (cpu == PLACEMENT_FAILED) return JOB_FAILED;
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", PARENT_NAME, cpu);
+  pid_t       pids[MAX_WORKERS];
+  int         alive[MAX_WORKERS] = {0};
+  int         started            = 0;
+  int         status             = 0;
+  int         timer              = -1;
+  int         signals            = -1;
+  sigset_t    child_signal;
+  sigemptyset(&child_signal);
+  sigaddset(&child_signal, SIGCHLD);
+
+  /**
+   * @brief Start the deadline and receive SIGCHLD through a file descriptor
+   * 
+   */
+  if (options->deadline > 0) {
+    timer = deadline_start(options->deadline);
+    ASSERT_GOTO(timer != -1, PARENT_NAME, "Error starting deadline\n",
+                Error_1);
+  }
+  sigprocmask(SIG_BLOCK, &child_signal, NULL);
+  signals = signalfd(-1, &child_signal, SFD_CLOEXEC | SFD_NONBLOCK);
+  ASSERT_GOTO(signals != -1, PARENT_NAME, "Error creating signalfd\n",
+              Error_1);
+
+  ASSERT_GOTO(scheduler_init(&scheduler, numberOfRandomNumbers, workers,
+                             options->chunk_size, options->stats) == 0,
+              PARENT_NAME, "Error initializing scheduler\n", Error_1);
+  process_safe_write(1, "%s Generated random numbers: %a\n", PARENT_NAME,
+                     scheduler.numbers, numberOfRandomNumbers);
+  process_safe_write(1, "%s Split into %d chunks for %d workers\n",
+                     PARENT_NAME, scheduler.chunk_count, workers);
+
+  /**
+   * @brief Fork the workers
+   * 
+   */
+  for (; started < workers; started++) {
+    pids[started] = spawn_worker(&scheduler, options, started);
+    ASSERT_GOTO(pids[started] != -1, PARENT_NAME, "Error forking\n", Error_0);
+    alive[started] = 1;
+  }
+
+  /**
+   * @brief Supervise the workers until every one of them has finished
+   * 
+   * A failed worker is respawned while the retry budget lasts. Its unacknowledged chunks
+   * go back to its own deque and the delay doubles with every failure of the same worker.
+   * The delay is waited on the deadline timer, so a deadline that expires during it
+   * cancels the job instead of respawning the worker. A respawned worker reports only
+   * the chunks of its last run.
+   * When the deadline expires the job is cancelled, and the workers that did not reach
+   * a chunk boundary within CANCEL_GRACE_MS are killed.
+   */
+  int running   = workers;
+  int restarts  = 0;
+  int cancelled = 0;
+  int failures[MAX_WORKERS] = {0};
+  while (running > 0) {
+    int   worker_status;
+    pid_t pid = waitpid(-1, &worker_status, WNOHANG);
+    ASSERT_GOTO(pid != -1, PARENT_NAME, "Error waiting for worker\n", Error_0);
+    if (pid == 0) {
+      int expired = deadline_wait(timer, signals, -1);
+      ASSERT_GOTO(expired != -1, PARENT_NAME, "Error waiting for worker\n",
+                  Error_0);
+      struct signalfd_siginfo info;
+      while (read(signals, &info, sizeof(info)) > 0)
+        ;
+      if (expired && !cancelled) {
+        cancelled = 1;
+        timer     = cancel_job(&scheduler, options, timer, pids, alive);
+      } else if (expired) {
+        kill_workers(pids, alive, workers);
+      }
+      continue;
+    }
+    int i = 0;
+    while (i < workers && pids[i] != pid) i++;
+    if (i == workers) continue;
+    alive[i] = 0;
+
+    if (WIFEXITED(worker_status) && WEXITSTATUS(worker_status) == 0) {
+      process_safe_write(1, "%s %d executed %d chunks, stole %d\n",
+                         WORKER_NAME, i, scheduler.deques[i].executed,
+                         scheduler.deques[i].stolen);
+      running--;
+      continue;
+    }
+    process_safe_write(2, "%s %d with PID %d failed\n", WORKER_NAME, i, pid);
+    if (restarts == options->retries || cancelled) {
+      status = -1;
+      running--;
+      continue;
+    }
+
+    int requeued = requeue_chunks(&scheduler, i);
+    ASSERT_GOTO(requeued != -1, PARENT_NAME, "Error requeueing chunks\n",
+                Error_0);
+    int delay = failures[i] < 10 ? RETRY_BACKOFF_MS << failures[i]
+                                 : MAX_BACKOFF_MS;
+    if (delay > MAX_BACKOFF_MS) delay = MAX_BACKOFF_MS;
+    failures[i]++;
+    restarts++;
+    process_safe_write(1, "%s Requeued %d chunks, respawning %s %d in %d ms\n",
+                       PARENT_NAME, requeued, WORKER_NAME, i, delay);
+    int expired = cancelled ? 0 : deadline_wait(timer, -1, delay);
+    ASSERT_GOTO(expired != -1, PARENT_NAME, "Error waiting for worker\n",
+                Error_0);
+    if (expired) {
+      cancelled = 1;
+      timer     = cancel_job(&scheduler, options, timer, pids, alive);
+      running--;
+      continue;
+    }
+    scheduler.deques[i].executed = 0;
+    scheduler.deques[i].stolen   = 0;
+    pids[i]                      = spawn_worker(&scheduler, options, i);
+    ASSERT_GOTO(pids[i] != -1, PARENT_NAME, "Error forking\n", Error_0);
+    alive[i] = 1;
+  }
+  if (timer != -1) close(timer);
+  close(signals);
+  sigprocmask(SIG_UNBLOCK, &child_signal, NULL);
+
+  /**
+   * @brief Discard the results of a cancelled job
+   * 
+   */
+  if (cancelled) {
+    int done = 0;
+    for (int i = 0; i < scheduler.chunk_count; i++)
+      if (scheduler.chunk_states[i] >= MAX_WORKERS) done++;
+    process_safe_write(1,
+                       "%s Job timed out with %d of %d chunks done, "
+                       "late results are discarded\n",
+                       PARENT_NAME, done, scheduler.chunk_count);
+    scheduler_destroy(&scheduler);
+    return JOB_TIMEOUT;
+  }
+
+  for (int i = 0; status == 0 && i < scheduler.chunk_count; i++)
+    if (scheduler.chunk_states[i] < MAX_WORKERS) status = -1;
+  ASSERT_GOTO(status == 0, PARENT_NAME, "Not every chunk was computed\n",
+              Error_1);
+  if (restarts > 0)
+    process_safe_write(1, "%s Respawned %d failed workers\n", PARENT_NAME,
+                       restarts);
+
+  /**
+   * @brief Merge the partial results in chunk order
+   * 
+   */
+  unsigned int sum     = 0;
+  unsigned int product = 1;
+  for (int i = 0; i < scheduler.chunk_count; i++) {
+    sum += (unsigned int)scheduler.results[i].sum;
+    product *= (unsigned int)scheduler.results[i].product;
+  }
+  process_safe_write(1, "%s Sum of random numbers: %d\n", PARENT_NAME,
+                     (int)sum);
+  process_safe_write(1, "%s Result of multiplication: %d\n", PARENT_NAME,
+                     (int)product);
+  process_safe_write(1, "%s Sum of the two results: %d\n", PARENT_NAME,
+                     (int)(sum + product));
+
+  /**
+   * @brief Merge the partial statistics of the workers
+   * 
+   */
+  if (scheduler.stats != NULL) {
+    for (int i = 1; i < workers; i++)
+      stream_stats_merge(&scheduler.stats[0], &scheduler.stats[i]);
+    stream_stats_print(PARENT_NAME, &scheduler.stats[0]);
+  }
+
+  scheduler_destroy(&scheduler);
+  process_safe_write(1, "%s Exiting\n", PARENT_NAME);
+  return JOB_OK;
+
+  /**
+   * @brief Error handling
+   * 
+   */
+Error_0:
+  for (int i = 0; i < started; i++)
+    if (alive[i]) kill(pids[i], SIGTERM);
+  while (wait(NULL) > 0)
+    ;
+Error_1:
+  if (timer != -1) close(timer);
+  if (signals != -1) close(signals);
+  sigprocmask(SIG_UNBLOCK, &child_signal, NULL);
+  scheduler_destroy(&scheduler);
+  return JOB_FAILED;
+}
@@ -0,0 +1,34 @@
+#include <sched.h>
+#include <spsc_queue.h>
+
+void spsc_queue_init(spsc_queue_t* queue) {
+  __atomic_store_n(&queue->head, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&queue->tail, 0, __ATOMIC_RELAXED);
+}
+
+int spsc_queue_push(spsc_queue_t* queue, const thread_message_t* message) {
+  unsigned int tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+  unsigned int head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+  if (tail - head == SPSC_QUEUE_CAPACITY) return -1;
+  queue->slots[tail & (SPSC_QUEUE_CAPACITY - 1)] = *message;
+  __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+int spsc_queue_pop(spsc_queue_t* queue, thread_message_t* message) {
+  unsigned int head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+  unsigned int tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+  if (head == tail) return -1;
+  *message = queue->slots[head & (SPSC_QUEUE_CAPACITY - 1)];
+  __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+void spsc_queue_push_wait(spsc_queue_t*            queue,
+                          const thread_message_t* message) {
+  while (spsc_queue_push(queue, message) == -1) sched_yield();
+}
+
+void spsc_queue_pop_wait(spsc_queue_t* queue, thread_message_t* message) {
+  while (spsc_queue_pop(queue, message) == -1) sched_yield();
+}
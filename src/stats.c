@@ -0,0 +1,216 @@
+#include <stats.h>
+#include <stdlib.h>
+#include <string.h>
+#include <write.h>
+
+/**
+ * @brief Value and weight of an item of the quantile sketch
+ */
+typedef struct weighted_item_s {
+  int     value;  /** Value of the item */
+  int64_t weight; /** Number of values the item stands for */
+} weighted_item_t;
+
+/**
+ * @brief Compare two integers for qsort
+ * 
+ * @param a The first integer
+ * @param b The second integer
+ * @return int Negative, zero or positive
+ */
+static int compare_ints(const void* a, const void* b) {
+  int x = *(const int*)a;
+  int y = *(const int*)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Compare two weighted items by value for qsort
+ * 
+ * @param a The first item
+ * @param b The second item
+ * @return int Negative, zero or positive
+ */
+static int compare_items(const void* a, const void* b) {
+  return compare_ints(&((const weighted_item_t*)a)->value,
+                      &((const weighted_item_t*)b)->value);
+}
+
+/**
+ * @brief Compact a full level, promoting every other item to the next level
+ * 
+ * The offset of the promoted items is random, so the rank error of the
+ * compaction has zero mean. A full next level is compacted first.
+ * 
+ * @param sketch The sketch
+ * @param level The level to compact
+ */
+static void kll_compact(kll_sketch_t* sketch, int level) {
+  /** @brief The top level has nowhere to promote to */
+  if (level + 1 >= KLL_LEVELS) return;
+  int* items = sketch->items[level];
+  int  size  = sketch->sizes[level];
+  if (sketch->sizes[level + 1] + size / 2 > KLL_CAPACITY) {
+    kll_compact(sketch, level + 1);
+  }
+  qsort(items, size, sizeof(int), compare_ints);
+
+  /** @brief xorshift32 for the offset of the promoted items */
+  sketch->random ^= sketch->random << 13;
+  sketch->random ^= sketch->random >> 17;
+  sketch->random ^= sketch->random << 5;
+
+  /** @brief Pairs are halved, an odd largest item stays in the level */
+  int* next = sketch->items[level + 1];
+  int  even = size & ~1;
+  for (int i = (int)(sketch->random & 1); i < even; i += 2) {
+    next[sketch->sizes[level + 1]++] = items[i];
+  }
+  if (size != even) items[0] = items[even];
+  sketch->sizes[level] = size - even;
+}
+
+/**
+ * @brief Add an item to a level of the sketch, compacting it when it is full
+ * 
+ * @param sketch The sketch
+ * @param level The level of the item
+ * @param value The value of the item
+ */
+static void kll_insert(kll_sketch_t* sketch, int level, int value) {
+  if (sketch->sizes[level] == KLL_CAPACITY) kll_compact(sketch, level);
+  if (sketch->sizes[level] == KLL_CAPACITY) return;
+  sketch->items[level][sketch->sizes[level]++] = value;
+}
+
+int stream_stats_init(stream_stats_t* stats, int min, int max, int bins) {
+  if (min > max || bins < 1 || bins > HISTOGRAM_MAX_BINS) return -1;
+  memset(stats, 0, sizeof(*stats));
+  stats->histogram.min  = min;
+  stats->histogram.max  = max;
+  stats->histogram.bins = bins;
+  stats->sketch.random  = 0x9E3779B9u;
+  return 0;
+}
+
+void stream_stats_update(stream_stats_t* stats, const int* values, int n) {
+  running_stats_t* moments   = &stats->moments;
+  histogram_t*     histogram = &stats->histogram;
+  int64_t          width     = (int64_t)histogram->max - histogram->min + 1;
+
+  for (int i = 0; i < n; i++) {
+    int value = values[i];
+
+    /** @brief Welford update of the mean and the squared differences */
+    moments->count++;
+    double delta = value - moments->mean;
+    moments->mean += delta / (double)moments->count;
+    moments->m2 += delta * (value - moments->mean);
+    if (moments->count == 1 || value < moments->min) moments->min = value;
+    if (moments->count == 1 || value > moments->max) moments->max = value;
+
+    if (value < histogram->min) {
+      histogram->underflow++;
+    } else if (value > histogram->max) {
+      histogram->overflow++;
+    } else {
+      int64_t offset = (int64_t)value - histogram->min;
+      histogram->counts[offset * histogram->bins / width]++;
+    }
+
+    kll_insert(&stats->sketch, 0, value);
+  }
+  stats->sketch.count += n;
+}
+
+void stream_stats_merge(stream_stats_t* stats, const stream_stats_t* other) {
+  running_stats_t*       moments = &stats->moments;
+  const running_stats_t* right   = &other->moments;
+  if (right->count == 0) return;
+
+  /** @brief Chan et al. combination of the two means and squared differences */
+  if (moments->count == 0) {
+    *moments = *right;
+  } else {
+    int64_t count = moments->count + right->count;
+    double  delta = right->mean - moments->mean;
+    moments->m2 += right->m2 + delta * delta * (double)moments->count *
+                                   (double)right->count / (double)count;
+    moments->mean += delta * (double)right->count / (double)count;
+    moments->count = count;
+    if (right->min < moments->min) moments->min = right->min;
+    if (right->max > moments->max) moments->max = right->max;
+  }
+
+  for (int i = 0; i < stats->histogram.bins; i++) {
+    stats->histogram.counts[i] += other->histogram.counts[i];
+  }
+  stats->histogram.underflow += other->histogram.underflow;
+  stats->histogram.overflow += other->histogram.overflow;
+
+  /** @brief Items keep their level, so their weights are unchanged */
+  for (int level = 0; level < KLL_LEVELS; level++) {
+    for (int i = 0; i < other->sketch.sizes[level]; i++) {
+      kll_insert(&stats->sketch, level, other->sketch.items[level][i]);
+    }
+  }
+  stats->sketch.count += other->sketch.count;
+}
+
+double stream_stats_variance(const stream_stats_t* stats) {
+  if (stats->moments.count == 0) return 0;
+  return stats->moments.m2 / (double)stats->moments.count;
+}
+
+int stream_stats_quantile(const stream_stats_t* stats, double q) {
+  const kll_sketch_t* sketch = &stats->sketch;
+  weighted_item_t     items[KLL_LEVELS * KLL_CAPACITY];
+  int                 count  = 0;
+  int64_t             total  = 0;
+
+  for (int level = 0; level < KLL_LEVELS; level++) {
+    for (int i = 0; i < sketch->sizes[level]; i++) {
+      items[count].value  = sketch->items[level][i];
+      items[count].weight = (int64_t)1 << level;
+      total += items[count++].weight;
+    }
+  }
+  if (count == 0) return 0;
+  qsort(items, count, sizeof(weighted_item_t), compare_items);
+
+  /** @brief Walk the cumulative weight up to the requested rank */
+  double  target = q * (double)total;
+  int64_t rank   = 0;
+  for (int i = 0; i < count; i++) {
+    rank += items[i].weight;
+    if ((double)rank >= target) return items[i].value;
+  }
+  return items[count - 1].value;
+}
+
+void stream_stats_print(const char* sender, const stream_stats_t* stats) {
+  const running_stats_t* moments   = &stats->moments;
+  const histogram_t*     histogram = &stats->histogram;
+  int64_t                width = (int64_t)histogram->max - histogram->min + 1;
+
+  process_safe_write(1, "%s Mean: %f, variance: %f, min: %d, max: %d\n",
+                     sender, moments->mean, stream_stats_variance(stats),
+                     moments->min, moments->max);
+  process_safe_write(1, "%s Quantiles p50: %d, p90: %d, p99: %d\n", sender,
+                     stream_stats_quantile(stats, 0.5),
+                     stream_stats_quantile(stats, 0.9),
+                     stream_stats_quantile(stats, 0.99));
+  for (int i = 0; i < histogram->bins; i++) {
+    int low  = (int)(histogram->min + (width * i + histogram->bins - 1) /
+                                          histogram->bins);
+    int high = (int)(histogram->min + (width * (i + 1) - 1) / histogram->bins);
+    if (low > high) continue;
+    process_safe_write(1, "%s Histogram [%d, %d]: %d\n", sender, low, high,
+                       (int)histogram->counts[i]);
+  }
+  if (histogram->underflow > 0 || histogram->overflow > 0) {
+    process_safe_write(1, "%s Histogram outside [%d, %d]: %d below, %d above\n",
+                       sender, histogram->min, histogram->max,
+                       (int)histogram->underflow, (int)histogram->overflow);
+  }
+}
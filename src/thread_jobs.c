@@ -0,0 +1,178 @@
+#include <affinity.h>
+#include <arena.h>
+#include <macros.h>
+#include <operations.h>
+#include <process_jobs.h>
+#include <pthread.h>
+#include <spsc_queue.h>
+#include <stats.h>
+#include <string.h>
+#include <thread_jobs.h>
+#include <write.h>
+
+static spsc_queue_t     first_queue;  /** Jobs from the main thread to the first thread */
+static spsc_queue_t     second_queue; /** Jobs from the main thread to the second thread */
+static spsc_queue_t     sum_queue;    /** Sums from the first thread to the second thread */
+static const options_t* engine_options = NULL; /** Options of the running job */
+static arena_t          job_arena      = {0};  /** Arena of the buffers of the current job */
+static stream_stats_t   stats;                 /** Streaming statistics of the first thread */
+
+/**
+ * @brief The job of the first thread
+ * 
+ * It will take the shared random numbers from its queue, calculate the sum, and push it to the second thread.
+ * 
+ * @param arg Unused
+ * @return void* NULL
+ */
+static void* first_thread(void* arg) {
+  (void)arg;
+  thread_message_t job;
+  int cpu = place_self(engine_options->cpus, engine_options->cpu_count, 1,
+                       FIRST_THREAD_NAME);
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", FIRST_THREAD_NAME, cpu);
+  spsc_queue_pop_wait(&first_queue, &job);
+
+  thread_message_t result = {0};
+  result.value            = sum_numbers(job.numbers, job.count);
+  spsc_queue_push_wait(&sum_queue, &result);
+
+  process_safe_write(1, "%s Sum of random numbers: %d\n", FIRST_THREAD_NAME,
+                     result.value);
+  if (engine_options->stats) {
+    stream_stats_init(&stats, HISTOGRAM_MIN, HISTOGRAM_MAX,
+                      HISTOGRAM_MAX - HISTOGRAM_MIN + 1);
+    stream_stats_update(&stats, job.numbers, job.count);
+    stream_stats_print(FIRST_THREAD_NAME, &stats);
+  }
+  process_safe_write(1, "%s Exiting\n", FIRST_THREAD_NAME);
+  return NULL;
+}
+
+/**
+ * @brief The job of the second thread
+ * 
+ * It will take the command and the shared random numbers from its queue, wait for the sum of the first thread,
+ * calculate the result of the command, and write the sum of the two threads' outputs to the stdout.
+ * 
+ * @param arg Pointer to the int that receives 0 on success, -1 on error
+ * @return void* NULL
+ */
+static void* second_thread(void* arg) {
+  int*             status = (int*)arg;
+  thread_message_t job;
+  thread_message_t sum;
+  int cpu = place_self(engine_options->cpus, engine_options->cpu_count, 2,
+                       SECOND_THREAD_NAME);
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", SECOND_THREAD_NAME, cpu);
+  spsc_queue_pop_wait(&second_queue, &job);
+  spsc_queue_pop_wait(&sum_queue, &sum);
+  process_safe_write(1, "%s Received sum: %d\n", SECOND_THREAD_NAME, sum.value);
+
+  if (strcmp(job.command, "multiply") == 0) {
+    int result = multiply_numbers(job.numbers, job.count);
+    process_safe_write(1, "%s Result of multiplication: %d\n",
+                       SECOND_THREAD_NAME, result);
+    process_safe_write(1, "%s Sum of two threads' results: %d\n",
+                       SECOND_THREAD_NAME, result + sum.value);
+    if (engine_options->exact &&
+        print_exact_result(SECOND_THREAD_NAME, job.numbers, job.count,
+                           sum.value, allowed_cpu_count()) == -1) {
+      *status = -1;
+      return NULL;
+    }
+  } else {
+    process_safe_write(2, "%s Invalid command: %s\n", SECOND_THREAD_NAME,
+                       job.command);
+    *status = -1;
+    return NULL;
+  }
+
+  process_safe_write(1, "%s Exiting\n", SECOND_THREAD_NAME);
+  *status = 0;
+  return NULL;
+}
+
+/**
+ * @brief The thread engine
+ * 
+ * It will generate random numbers, start the two worker threads and hand them the shared array and the command.
+ * 
+ * @param options The options of the job
+ * @return int 0 on success, -1 on error
+ */
+int thread_engine(const options_t* options) {
+  int              numberOfRandomNumbers = options->numberOfRandomNumbers;
+  pthread_t        threads[2];
+  int              second_status = -1;
+  thread_message_t job           = {0};
+
+  /**
+   * @brief Generate random numbers
+   * 
+   */
+  engine_options = options;
+  int cpu        = place_self(options->cpus, options->cpu_count, 0,
+                              PARENT_NAME);
+  if (cpu == PLACEMENT_FAILED) return -1;
+  if (cpu != -1)
+    process_safe_write(1, "%s Pinned to CPU %d\n", PARENT_NAME, cpu);
+  arena_init(&job_arena, options->huge_pages);
+  int* randomNumbers =
+      (int*)arena_alloc(&job_arena, numberOfRandomNumbers * sizeof(int));
+  ASSERT_GOTO(randomNumbers != NULL, PARENT_NAME, "Error allocating memory\n",
+              Error_2);
+  generate_random_numbers(randomNumbers, numberOfRandomNumbers);
+  process_safe_write(1, "%s Generated random numbers: %a\n", PARENT_NAME,
+                     randomNumbers, numberOfRandomNumbers);
+
+  /**
+   * @brief Start the worker threads
+   * 
+   */
+  spsc_queue_init(&first_queue);
+  spsc_queue_init(&second_queue);
+  spsc_queue_init(&sum_queue);
+  ASSERT_GOTO(pthread_create(&threads[0], NULL, first_thread, NULL) == 0,
+              PARENT_NAME, "Error creating first thread\n", Error_1);
+  ASSERT_GOTO(pthread_create(&threads[1], NULL, second_thread,
+                             &second_status) == 0,
+              PARENT_NAME, "Error creating second thread\n", Error_0);
+
+  /**
+   * @brief Hand the shared array and the command to the threads
+   * 
+   */
+  job.numbers = randomNumbers;
+  job.count   = numberOfRandomNumbers;
+  spsc_queue_push_wait(&first_queue, &job);
+  job.command = "multiply";
+  spsc_queue_push_wait(&second_queue, &job);
+
+  /**
+   * @brief Wait for the threads to finish
+   * 
+   */
+  pthread_join(threads[0], NULL);
+  pthread_join(threads[1], NULL);
+  arena_destroy(&job_arena);
+  process_safe_write(1, "%s Exiting\n", PARENT_NAME);
+  return second_status;
+
+  /**
+   * @brief Error handling
+   * The first thread is waiting for its job, hand it an empty one so it can be joined.
+   * 
+   */
+Error_0:
+  job.numbers = randomNumbers;
+  job.count   = 0;
+  spsc_queue_push_wait(&first_queue, &job);
+  pthread_join(threads[0], NULL);
+Error_1:
+  arena_destroy(&job_arena);
+Error_2:
+  return -1;
+}
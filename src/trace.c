@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <deadline.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <safe_io.h>
+#include <string.h>
+#include <time.h>
+#include <trace.h>
+#include <unistd.h>
+
+int trace_open(trace_t* trace, const char* path, uint32_t job, int create) {
+  int flags       = O_WRONLY | O_CREAT | O_APPEND | (create ? O_TRUNC : 0);
+  trace->fd       = open(path, flags, 0644);
+  trace->job      = job;
+  trace->sequence = 0;
+  trace->used     = 0;
+  if (trace->fd == -1) return -1;
+  if (create) {
+    trace_file_header_t header = {TRACE_MAGIC, TRACE_VERSION};
+    if (write_all(trace->fd, &header, sizeof(header)) == -1) {
+      close(trace->fd);
+      trace->fd = -1;
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int trace_record(trace_t* trace, int channel, int sender,
+                 const struct iovec* iov, int iovcnt) {
+  if (trace->fd == -1 || iovcnt > TRACE_MAX_IOV) return -1;
+  size_t size = 0;
+  for (int i = 0; i < iovcnt; i++) size += iov[i].iov_len;
+  trace_record_t record = {trace_now(), trace->job, trace->sequence++,
+                           (uint16_t)channel, (uint16_t)sender, (uint32_t)size};
+
+  if (trace->used + sizeof(record) + size > TRACE_BUFFER_SIZE &&
+      trace_flush(trace) == -1)
+    return -1;
+
+  /**
+   * @brief A record bigger than the buffer is written in a single call, so appends of the other processes do not split it
+   * 
+   */
+  if (sizeof(record) + size > TRACE_BUFFER_SIZE) {
+    struct iovec parts[TRACE_MAX_IOV + 1];
+    parts[0].iov_base = &record;
+    parts[0].iov_len  = sizeof(record);
+    memcpy(parts + 1, iov, iovcnt * sizeof(struct iovec));
+    return writev_all(trace->fd, parts, iovcnt + 1) == -1 ? -1 : 0;
+  }
+
+  memcpy(trace->buffer + trace->used, &record, sizeof(record));
+  trace->used += sizeof(record);
+  for (int i = 0; i < iovcnt; i++) {
+    memcpy(trace->buffer + trace->used, iov[i].iov_base, iov[i].iov_len);
+    trace->used += iov[i].iov_len;
+  }
+  return 0;
+}
+
+int trace_flush(trace_t* trace) {
+  if (trace->fd == -1 || trace->used == 0) return 0;
+  ssize_t written = write_all(trace->fd, trace->buffer, trace->used);
+  trace->used     = 0;
+  return written == -1 ? -1 : 0;
+}
+
+void trace_close(trace_t* trace) {
+  if (trace->fd == -1) return;
+  trace_flush(trace);
+  close(trace->fd);
+  trace->fd = -1;
+}
+
+int trace_reader_open(const char* path) {
+  trace_file_header_t header;
+  int                 fd = open(path, O_RDONLY);
+  if (fd == -1) return -1;
+  if (read_all(fd, &header, sizeof(header)) != sizeof(header) ||
+      header.magic != TRACE_MAGIC || header.version != TRACE_VERSION) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int trace_read_record(int fd, trace_record_t* record) {
+  ssize_t n = read_all(fd, record, sizeof(*record));
+  if (n == 0) return 0;
+  return n == sizeof(*record) ? 1 : -1;
+}
+
+uint64_t trace_now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/**
+ * @brief Sleep until an absolute CLOCK_MONOTONIC time
+ * 
+ * @param target The time to wake up at in nanoseconds
+ * @return int 0 on success, -1 on error
+ */
+static int sleep_until(uint64_t target) {
+  struct timespec wake = {(time_t)(target / 1000000000u),
+                          (long)(target % 1000000000u)};
+  int             error;
+  while ((error = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake,
+                                  NULL)) == EINTR)
+    ;
+  return error == 0 ? 0 : -1;
+}
+
+int trace_pace(uint64_t start, uint64_t offset, int timer) {
+  uint64_t target = start + offset;
+  uint64_t now;
+  while (timer != -1 && (now = trace_now()) + 1000000u <= target) {
+    int expired = deadline_wait(timer, -1, (int)((target - now) / 1000000u));
+    if (expired != 0) return expired;
+  }
+  return sleep_until(target);
+}
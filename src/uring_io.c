@@ -0,0 +1,298 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <safe_io.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <uring_io.h>
+
+/**
+ * @brief Enter the ring
+ * 
+ * @param ring The ring
+ * @param to_submit The number of entries to submit
+ * @param min_complete The number of completions to wait for
+ * @return int The number of submitted entries, -1 on error
+ */
+static int uring_enter(uring_t* ring, unsigned to_submit,
+                       unsigned min_complete) {
+  return syscall(SYS_io_uring_enter, ring->fd, to_submit, min_complete,
+                 min_complete > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+}
+
+int uring_init(uring_t* ring) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  memset(ring, 0, sizeof(*ring));
+  ring->fd = syscall(SYS_io_uring_setup, URING_ENTRIES, &params);
+  if (ring->fd == -1) return -1;
+
+  ring->entries      = params.sq_entries;
+  ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+  ring->sqes    = (struct io_uring_sqe*)mmap(
+      NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring->fd, IORING_OFF_SQES);
+  if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED ||
+      ring->sqes == MAP_FAILED)
+    goto Error;
+
+  char* sq       = (char*)ring->sq_ring;
+  char* cq       = (char*)ring->cq_ring;
+  ring->sq_head  = (unsigned*)(sq + params.sq_off.head);
+  ring->sq_tail  = (unsigned*)(sq + params.sq_off.tail);
+  ring->sq_mask  = (unsigned*)(sq + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+  ring->cq_head  = (unsigned*)(cq + params.cq_off.head);
+  ring->cq_tail  = (unsigned*)(cq + params.cq_off.tail);
+  ring->cq_mask  = (unsigned*)(cq + params.cq_off.ring_mask);
+  ring->cqes     = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+  return 0;
+
+Error:
+  if (ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+  if (ring->cq_ring != MAP_FAILED) munmap(ring->cq_ring, ring->cq_ring_size);
+  if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+  close(ring->fd);
+  ring->fd = -1;
+  return -1;
+}
+
+void uring_destroy(uring_t* ring) {
+  if (ring->fd == -1) return;
+  uring_submit_wait(ring);
+  munmap(ring->sq_ring, ring->sq_ring_size);
+  munmap(ring->cq_ring, ring->cq_ring_size);
+  munmap(ring->sqes, ring->sqes_size);
+  close(ring->fd);
+  ring->fd = -1;
+}
+
+int uring_register_files(uring_t* ring, const int* fds, int count) {
+  if (count > URING_MAX_FILES) return -1;
+  if (ring->file_count > 0) {
+    syscall(SYS_io_uring_register, ring->fd, IORING_UNREGISTER_FILES, NULL, 0);
+    ring->file_count = 0;
+  }
+  if (syscall(SYS_io_uring_register, ring->fd, IORING_REGISTER_FILES, fds,
+              count) == -1)
+    return -1;
+  memcpy(ring->files, fds, count * sizeof(int));
+  ring->file_count = count;
+  return 0;
+}
+
+int uring_register_buffer(uring_t* ring, void* buf, size_t len) {
+  if (ring->buffer != NULL) {
+    syscall(SYS_io_uring_register, ring->fd, IORING_UNREGISTER_BUFFERS, NULL,
+            0);
+    ring->buffer = NULL;
+  }
+  struct iovec iov = {buf, len};
+  if (syscall(SYS_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, &iov,
+              1) == -1)
+    return -1;
+  ring->buffer      = (char*)buf;
+  ring->buffer_size = len;
+  return 0;
+}
+
+/**
+ * @brief Check whether the operation queue has no room left
+ * 
+ * @param ring The ring
+ * @return int 1 if the queue is full, 0 otherwise
+ */
+static int queue_full(const uring_t* ring) {
+  return !ring->completed && (ring->op_count == URING_ENTRIES ||
+                              (unsigned)ring->op_count == ring->entries);
+}
+
+int uring_queue(uring_t* ring, int write, int fd, void* buf, size_t len) {
+  if (queue_full(ring) && uring_submit_wait(ring) == -1) return -1;
+  if (ring->completed) {
+    ring->op_count  = 0;
+    ring->completed = 0;
+  }
+  uring_op_t* op = &ring->ops[ring->op_count];
+  op->write      = write;
+  op->fd         = fd;
+  op->buf        = (char*)buf;
+  op->len        = len;
+  op->done       = 0;
+  op->eof        = 0;
+  op->res        = 0;
+  return ring->op_count++;
+}
+
+/**
+ * @brief Fill a submission queue entry for the rest of an operation
+ * 
+ * Registered file descriptors and buffers are used when the operation refers to them.
+ * 
+ * @param ring The ring
+ * @param sqe The submission queue entry
+ * @param op The operation
+ * @param index The index of the operation
+ */
+static void prepare_sqe(uring_t* ring, struct io_uring_sqe* sqe,
+                        const uring_op_t* op, int index) {
+  char* buf = op->buf + op->done;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode    = op->write ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd        = op->fd;
+  sqe->addr      = (unsigned long)buf;
+  sqe->len       = op->len - op->done;
+  sqe->off       = (__u64)-1;
+  sqe->user_data = index;
+
+  for (int i = 0; i < ring->file_count; i++) {
+    if (ring->files[i] == op->fd) {
+      sqe->fd = i;
+      sqe->flags |= IOSQE_FIXED_FILE;
+      break;
+    }
+  }
+  if (ring->buffer != NULL && buf >= ring->buffer &&
+      buf + sqe->len <= ring->buffer + ring->buffer_size) {
+    sqe->opcode    = op->write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    sqe->buf_index = 0;
+  }
+}
+
+/**
+ * @brief Queue a request that cancels every operation still in flight
+ * 
+ * @param ring The ring
+ * @param tail The tail of the submission queue, advanced past the request
+ */
+static void queue_cancel(uring_t* ring, unsigned* tail) {
+  unsigned             slot = *tail & *ring->sq_mask;
+  struct io_uring_sqe* sqe  = &ring->sqes[slot];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode          = IORING_OP_ASYNC_CANCEL;
+  sqe->fd              = -1;
+  sqe->cancel_flags    = IORING_ASYNC_CANCEL_ANY;
+  sqe->user_data       = URING_CANCEL;
+  ring->sq_array[slot] = slot;
+  (*tail)++;
+  __atomic_store_n(ring->sq_tail, *tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Submit the unfinished operations from first on as one linked chain and reap their completions
+ * 
+ * Without a wait function the completions are awaited in io_uring_enter. Otherwise the ring is only
+ * entered to submit, and wait is called on the ring file descriptor until every completion arrived.
+ * If wait gives up, the operations in flight are cancelled and reaped before the function returns,
+ * so none of them touches its buffer afterwards.
+ * 
+ * @param ring The ring
+ * @param first The index of the first unfinished operation
+ * @param wait The function that waits for completions, NULL to wait in the kernel
+ * @return int 0 on success, -1 on error or if wait gave up
+ */
+static int submit_chain(uring_t* ring, int first, io_wait_t wait) {
+  unsigned tail      = *ring->sq_tail;
+  int      count     = ring->op_count - first;
+  int      cancelled = 0;
+  for (int i = first; i < ring->op_count; i++) {
+    unsigned slot = tail & *ring->sq_mask;
+    prepare_sqe(ring, &ring->sqes[slot], &ring->ops[i], i);
+    if (i + 1 < ring->op_count) ring->sqes[slot].flags |= IOSQE_IO_LINK;
+    ring->sq_array[slot] = slot;
+    tail++;
+  }
+  __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+  int reaped = 0;
+  while (reaped < count) {
+    unsigned pending =
+        tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    unsigned min_complete = wait == NULL || cancelled ? 1 : 0;
+    if (uring_enter(ring, pending, min_complete) == -1 && errno != EINTR)
+      return -1;
+
+    unsigned head = *ring->cq_head;
+    while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+      struct io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+      if (cqe->user_data != URING_CANCEL) {
+        ring->ops[cqe->user_data].res = cqe->res;
+        reaped++;
+      }
+      head++;
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    if (reaped < count && min_complete == 0 &&
+        wait(ring->fd, POLLIN) == -1) {
+      queue_cancel(ring, &tail);
+      cancelled = 1;
+    }
+  }
+  return cancelled ? -1 : 0;
+}
+
+int uring_submit_poll(uring_t* ring, io_wait_t wait) {
+  int first  = ring->completed ? ring->op_count : 0;
+  int status = 0;
+  while (first < ring->op_count) {
+    if (submit_chain(ring, first, wait) == -1) {
+      status = -1;
+      break;
+    }
+
+    /**
+     * @brief Account the completions in order
+     * The first operation that did not finish breaks the chain, it and everything after it is submitted again.
+     * 
+     */
+    int i = first;
+    for (; i < ring->op_count; i++) {
+      uring_op_t* op = &ring->ops[i];
+      if (op->res == -ECANCELED || op->res == -EINTR || op->res == -EAGAIN) break;
+      if (op->res < 0) {
+        status = -1;
+        break;
+      }
+      op->done += op->res;
+      if (op->res == 0 && !op->write) op->eof = 1;
+      if (op->done < op->len && !op->eof) break;
+    }
+    if (status == -1) break;
+    first = i;
+  }
+  if (status == -1) ring->op_count = 0;
+  ring->completed = 1;
+  ring->log_used  = 0;
+  return status;
+}
+
+int uring_submit_wait(uring_t* ring) { return uring_submit_poll(ring, NULL); }
+
+ssize_t uring_done(const uring_t* ring, int op) { return ring->ops[op].done; }
+
+ssize_t uring_queue_log(uring_t* ring, int fd, const void* buf, size_t len) {
+  if (len > URING_LOG_SIZE) {
+    if (uring_submit_wait(ring) == -1) return -1;
+    return write_all(fd, buf, len);
+  }
+  if (ring->log_used + len > URING_LOG_SIZE || queue_full(ring))
+    if (uring_submit_wait(ring) == -1) return -1;
+  char* copy = ring->log + ring->log_used;
+  memcpy(copy, buf, len);
+  ring->log_used += len;
+  if (uring_queue(ring, 1, fd, copy, len) == -1) return -1;
+  return len;
+}
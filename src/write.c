@@ -1,6 +1,8 @@
+#include <limits.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <safe_io.h>
 #include <unistd.h>
 #include <write.h>
 
@@ -8,6 +10,26 @@
 #define BUFFER_SIZE 1024
 #endif
 
+static write_sink_t write_sink = NULL; /** Function that writes the log lines */
+
+void set_write_sink(write_sink_t sink) { write_sink = sink; }
+
+/**
+ * @brief Write a finished log line with the current sink
+ * 
+ * @param fd The file descriptor
+ * @param buf The buffer to write
+ * @param count The number of bytes to write
+ */
+static void sink_write(int fd, const void* buf, size_t count) {
+  if (write_sink != NULL) {
+    (void)!write_sink(fd, buf, count);
+  } else {
+    (void)!write_all(fd, buf, count);
+    fsync(fd);
+  }
+}
+
 void write_char(char* buffer, char c, int* index, int len) {
   if (*index + 1 < len) buffer[(*index)++] = c;
 }
@@ -56,6 +78,26 @@ void write_int_array(char* buffer, int* arr, int n, int* index, int len) {
   }
 }
 
+void write_fixed(char* buffer, double x, int* index, int len) {
+  char digits[24];
+  int  count = 0;
+  if (*index + 26 >= len || !(x > -1e18 && x < 1e18)) return;
+  if (x < 0) {
+    write_char(buffer, '-', index, len);
+    x = -x;
+  }
+  /** @brief Round to thousandths, then emit the digits from the right */
+  unsigned long long scaled = (unsigned long long)(x * 1000.0 + 0.5);
+  do {
+    digits[count++] = (char)('0' + scaled % 10);
+    scaled /= 10;
+  } while (scaled > 0 || count < 4);
+  while (count > 0) {
+    if (count == 3) write_char(buffer, '.', index, len);
+    write_char(buffer, digits[--count], index, len);
+  }
+}
+
 void write_style(char* buffer, style_t style, int* index, int len) {
   switch (style) {
     case ERROR:
@@ -67,53 +109,84 @@ void write_style(char* buffer, style_t style, int* index, int len) {
   }
 }
 
+/**
+ * @brief Grow the line buffer so that a string fits after the current index
+ * 
+ * @param buffer The line buffer, replaced by a heap buffer when it grows
+ * @param stack The initial buffer on the stack
+ * @param index The index of the buffer
+ * @param len The length of the buffer, updated when it grows
+ * @param needed The number of bytes that must fit after the index
+ * 
+ * The line stays in the old buffer if the allocation fails.
+ */
+static void grow_buffer(char** buffer, char* stack, int index, int* len,
+                        int needed) {
+  int   size  = index + needed + BUFFER_SIZE;
+  char* grown = malloc(size + 1);
+  if (grown == NULL) return;
+  memcpy(grown, *buffer, index);
+  if (*buffer != stack) free(*buffer);
+  *buffer = grown;
+  *len    = size;
+}
+
 void process_safe_write(int fd, const char* format, ...) {
   va_list args;
   va_start(args, format);
-  int  index                   = 0;
-  int  is_style                = 0;
-  char buffer[BUFFER_SIZE + 1] = {0};
+  int   index                  = 0;
+  int   is_style               = 0;
+  char  stack[BUFFER_SIZE + 1] = {0};
+  char* buffer                 = stack;
+  int   len                    = BUFFER_SIZE;
 
-  int* array      = 0;
-  int  array_size = 0;
+  int*        array      = 0;
+  int         array_size = 0;
+  const char* string     = 0;
   while (*format != '\0') {
     if (*format == '%') {
       format++;
       switch (*format) {
         case 's':
-          write_string(buffer, va_arg(args, const char*), &index, BUFFER_SIZE);
+          string = va_arg(args, const char*);
+          if (index + (int)strlen(string) >= len)
+            grow_buffer(&buffer, stack, index, &len, (int)strlen(string));
+          write_string(buffer, string, &index, len);
           break;
         case 'c':
-          write_char(buffer, va_arg(args, int), &index, BUFFER_SIZE);
+          write_char(buffer, va_arg(args, int), &index, len);
           break;
         case 'd':
-          write_int(buffer, va_arg(args, int), &index, BUFFER_SIZE);
+          write_int(buffer, va_arg(args, int), &index, len);
+          break;
+        case 'f':
+          write_fixed(buffer, va_arg(args, double), &index, len);
           break;
         case 'a':
           array      = va_arg(args, int*);
           array_size = va_arg(args, int);
-          write_int_array(buffer, array, array_size, &index, BUFFER_SIZE);
+          write_int_array(buffer, array, array_size, &index, len);
           break;
         case 'e':
           is_style = 1;
-          write_style(buffer, ERROR, &index, BUFFER_SIZE);
+          write_style(buffer, ERROR, &index, len);
           break;
         case 'r':
           is_style = 1;
-          write_style(buffer, RESET, &index, BUFFER_SIZE);
+          write_style(buffer, RESET, &index, len);
           break;
         default:
-          write_string(buffer, "%% BAD FORMAT %%", &index, BUFFER_SIZE);
+          write_string(buffer, "%% BAD FORMAT %%", &index, len);
           break;
       }
     } else {
-      write_char(buffer, *format, &index, BUFFER_SIZE);
+      write_char(buffer, *format, &index, len);
     }
     format++;
   }
-  if (is_style) write_style(buffer, RESET, &index, BUFFER_SIZE);
-  (void)!write(fd, buffer, index);
-  fsync(fd);
+  if (is_style) write_style(buffer, RESET, &index, len);
+  sink_write(fd, buffer, index);
+  if (buffer != stack) free(buffer);
   va_end(args);
 }
 
@@ -121,6 +194,7 @@ int str2uint(const char* str) {
   int result = 0;
   while (*str != '\0') {
     if (*str < '0' || *str > '9') return -1;
+    if (result > (INT_MAX - (*str - '0')) / 10) return -1;
     result = result * 10 + *str - '0';
     str++;
   }